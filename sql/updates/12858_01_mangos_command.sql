@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12848_01_mangos_spell_template required_12858_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server dbstats';
+INSERT INTO command VALUES
+('server dbstats',3,'Syntax: .server dbstats [reset]\r\n\r\nShow call counts and latencies of the most expensive statements and queries, connection lock waits and async queue depth of all databases. Requires DatabaseMetrics enabled in the config file.\r\nWith reset the collected metrics are cleared.');
@@ -0,0 +1,284 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_FLATHASHMAP_H
+#define MANGOS_FLATHASHMAP_H
+
+#include "Platform/Define.h"
+#include <new>
+#include <vector>
+#include <utility>
+
+/**
+ * Hash map for integer keys with open addressing, meant for big read-mostly stores.
+ *
+ * Values are kept in contiguous blocks of CHUNK_SIZE entries and the hash index is a flat array
+ * of value positions probed linearly, so a lookup touches two cache lines instead of following
+ * node pointers, and an entry costs a few bytes of index instead of a heap node.
+ * Like for UNORDERED_MAP, references to values stay valid until the value is erased:
+ * blocks are never moved and erased positions are only reused by later inserts.
+ * Iteration order is unspecified.
+ */
+template<class K, class V>
+class FlatHashMap
+{
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef std::pair<K const, V> value_type;       // key can't be changed through an iterator
+        typedef size_t size_type;
+
+        template<class Map, class Value>
+        class Iterator
+        {
+                friend class FlatHashMap;
+
+            public:
+                Iterator() : m_map(NULL), m_index(0) {}
+                // iterator to const_iterator
+                template<class OtherMap, class OtherValue>
+                Iterator(Iterator<OtherMap, OtherValue> const& other) : m_map(other.m_map), m_index(other.m_index) {}
+
+                Value& operator*() const { return m_map->GetValue(m_index); }
+                Value* operator->() const { return &m_map->GetValue(m_index); }
+
+                Iterator& operator++() { ++m_index; SkipUnused(); return *this; }
+                Iterator operator++(int) { Iterator itr = *this; ++*this; return itr; }
+
+                bool operator==(Iterator const& other) const { return m_index == other.m_index; }
+                bool operator!=(Iterator const& other) const { return m_index != other.m_index; }
+
+            private:
+                template<class OtherMap, class OtherValue> friend class Iterator;
+
+                Iterator(Map* map, size_t index) : m_map(map), m_index(index) { SkipUnused(); }
+
+                void SkipUnused()
+                {
+                    while (m_index < m_map->m_used.size() && !m_map->m_used[m_index])
+                        ++m_index;
+                }
+
+                Map* m_map;
+                size_t m_index;
+        };
+
+        typedef Iterator<FlatHashMap, value_type> iterator;
+        typedef Iterator<FlatHashMap const, value_type const> const_iterator;
+
+        FlatHashMap() : m_end(0), m_size(0) {}
+        FlatHashMap(FlatHashMap const& other) : m_end(0), m_size(0) { CopyFrom(other); }
+        ~FlatHashMap() { clear(); }
+
+        FlatHashMap& operator=(FlatHashMap const& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                CopyFrom(other);
+            }
+            return *this;
+        }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, m_end); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_end); }
+
+        size_type size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        iterator find(K const& key)
+        {
+            size_t slot = FindSlot(key);
+            return slot != NOT_FOUND ? iterator(this, m_slots[slot] - 1) : end();
+        }
+
+        const_iterator find(K const& key) const
+        {
+            size_t slot = FindSlot(key);
+            return slot != NOT_FOUND ? const_iterator(this, m_slots[slot] - 1) : end();
+        }
+
+        size_type count(K const& key) const { return FindSlot(key) != NOT_FOUND ? 1 : 0; }
+
+        V& operator[](K const& key) { return Insert(value_type(key, V())).first->second; }
+
+        std::pair<iterator, bool> insert(value_type const& value) { return Insert(value); }
+
+        size_type erase(K const& key)
+        {
+            size_t slot = FindSlot(key);
+            if (slot == NOT_FOUND)
+                return 0;
+
+            EraseSlot(slot);
+            return 1;
+        }
+
+        // iterators to other values stay valid
+        void erase(iterator itr) { EraseSlot(FindSlot(itr->first)); }
+
+        void clear()
+        {
+            for (size_t index = 0; index < m_end; ++index)
+                if (m_used[index])
+                    GetValue(index).~value_type();
+
+            for (size_t i = 0; i < m_chunks.size(); ++i)
+                ::operator delete(m_chunks[i]);
+
+            m_chunks.clear();
+            m_end = 0;
+            m_used.clear();
+            m_free.clear();
+            m_slots.clear();
+            m_size = 0;
+        }
+
+        void reserve(size_type count)
+        {
+            size_t slots = MIN_SLOTS;
+            while (slots * 3 < count * 4)
+                slots *= 2;
+
+            if (slots > m_slots.size())
+                Rehash(slots);
+        }
+
+    private:
+        static const size_t NOT_FOUND = size_t(-1);
+        static const size_t MIN_SLOTS = 16;
+        static const size_t CHUNK_SIZE = 256;               // values per block
+
+        value_type& GetValue(size_t index) { return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+        value_type const& GetValue(size_t index) const { return m_chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+        size_t HomeSlot(K const& key) const
+        {
+            // multiplicative mixing, sequential ids spread over the whole index
+            uint32 hash = uint32(key) * 0x9E3779B1u;
+            return (hash ^ (hash >> 16)) & (m_slots.size() - 1);
+        }
+
+        size_t FindSlot(K const& key) const
+        {
+            if (m_slots.empty())
+                return NOT_FOUND;
+
+            for (size_t slot = HomeSlot(key);; slot = (slot + 1) & (m_slots.size() - 1))
+            {
+                if (!m_slots[slot])
+                    return NOT_FOUND;
+                if (GetValue(m_slots[slot] - 1).first == key)
+                    return slot;
+            }
+        }
+
+        std::pair<iterator, bool> Insert(value_type const& value)
+        {
+            size_t slot = FindSlot(value.first);
+            if (slot != NOT_FOUND)
+                return std::make_pair(iterator(this, m_slots[slot] - 1), false);
+
+            // keep the load factor below 3/4
+            if ((m_size + 1) * 4 > m_slots.size() * 3)
+                Rehash(m_slots.empty() ? MIN_SLOTS : m_slots.size() * 2);
+
+            size_t index;
+            if (!m_free.empty())
+            {
+                index = m_free.back();
+                new (&GetValue(index)) value_type(value);
+                m_free.pop_back();
+                m_used[index] = true;
+            }
+            else
+            {
+                if (m_end == m_chunks.size() * CHUNK_SIZE)
+                    m_chunks.push_back(static_cast<value_type*>(::operator new(CHUNK_SIZE * sizeof(value_type))));
+
+                index = m_end;
+                new (&GetValue(index)) value_type(value);
+                ++m_end;
+                m_used.push_back(true);
+            }
+
+            for (slot = HomeSlot(value.first); m_slots[slot]; slot = (slot + 1) & (m_slots.size() - 1)) {}
+            m_slots[slot] = index + 1;
+            ++m_size;
+
+            return std::make_pair(iterator(this, index), true);
+        }
+
+        void EraseSlot(size_t slot)
+        {
+            size_t index = m_slots[slot] - 1;
+            GetValue(index).~value_type();
+            m_used[index] = false;
+            m_free.push_back(index);
+            --m_size;
+
+            // shift following entries of the probe sequence back, no tombstones needed
+            size_t mask = m_slots.size() - 1;
+            m_slots[slot] = 0;
+            for (size_t next = (slot + 1) & mask; m_slots[next]; next = (next + 1) & mask)
+            {
+                size_t home = HomeSlot(GetValue(m_slots[next] - 1).first);
+                // entry can be moved if its home is not in the cyclic range (slot, next]
+                bool between = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+                if (between)
+                    continue;
+
+                m_slots[slot] = m_slots[next];
+                m_slots[next] = 0;
+                slot = next;
+            }
+        }
+
+        void CopyFrom(FlatHashMap const& other)
+        {
+            reserve(other.size());
+            for (const_iterator itr = other.begin(); itr != other.end(); ++itr)
+                Insert(*itr);
+        }
+
+        void Rehash(size_t slots)
+        {
+            m_slots.assign(slots, 0);
+            for (size_t index = 0; index < m_end; ++index)
+            {
+                if (!m_used[index])
+                    continue;
+
+                size_t slot = HomeSlot(GetValue(index).first);
+                while (m_slots[slot])
+                    slot = (slot + 1) & (slots - 1);
+                m_slots[slot] = index + 1;
+            }
+        }
+
+        std::vector<value_type*> m_chunks;                  // raw blocks of CHUNK_SIZE values, never moved
+        size_t m_end;                                       // positions in m_chunks used so far
+        std::vector<bool> m_used;                           // position holds a constructed value
+        std::vector<uint32> m_free;                         // erased positions in m_chunks
+        std::vector<uint32> m_slots;                        // position in m_chunks + 1, 0 for empty slot
+        size_t m_size;
+};
+
+#endif
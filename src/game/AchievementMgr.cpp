@@ -369,6 +369,7 @@ bool AchievementCriteriaRequirement::Meets(uint32 criteria_id, Player const* sou
                     ACHIEVEMENT_CRITERIA_REQUIRE_INSTANCE_SCRIPT, criteria_id, source->GetMapId());
                 return false;
             }
+            Map::ScriptGuard guard(*source->GetMap());
             return data->CheckAchievementCriteriaMeet(criteria_id, source, target, miscvalue1);
         }
         case ACHIEVEMENT_CRITERIA_REQUIRE_S_EQUIPPED_ITEM_LVL:
@@ -555,13 +556,11 @@ void AchievementMgr::SaveToDB()
 {
     if (!m_completedAchievements.empty())
     {
-        static SqlStatementID delComplAchievements;
-        static SqlStatementID insComplAchievements;
+        static SqlStatementID replaceRow;
+        static SqlStatementID replaceRows;
+        SqlBatchInsert replaceStmt(CharacterDatabase, replaceRow, replaceRows, "REPLACE INTO character_achievement (guid, achievement, date) VALUES ", 3);
 
-        SqlStatement delStmt = CharacterDatabase.CreateStatement(delComplAchievements, "DELETE FROM character_achievement WHERE guid = ? AND achievement = ?");
-        SqlStatement insStmt = CharacterDatabase.CreateStatement(insComplAchievements, "INSERT INTO character_achievement (guid, achievement, date) VALUES (?, ?, ?)");
-
-        // delete existing achievements in the loop
+        // replace existing achievements in the loop
         for (CompletedAchievementMap::iterator iter = m_completedAchievements.begin(); iter != m_completedAchievements.end(); ++iter)
         {
             if (!iter->second.changed)
@@ -570,18 +569,18 @@ void AchievementMgr::SaveToDB()
             /// mark as saved in db
             iter->second.changed = false;
 
-            delStmt.PExecute(GetPlayer()->GetGUIDLow(), iter->first);
-            insStmt.PExecute(GetPlayer()->GetGUIDLow(), iter->first, uint64(iter->second.date));
+            replaceStmt.AddRow(GetPlayer()->GetGUIDLow(), iter->first, uint64(iter->second.date));
         }
     }
 
     if (!m_criteriaProgress.empty())
     {
         static SqlStatementID delProgress;
-        static SqlStatementID insProgress;
 
         SqlStatement delStmt = CharacterDatabase.CreateStatement(delProgress, "DELETE FROM character_achievement_progress WHERE guid = ? AND criteria = ?");
-        SqlStatement insStmt = CharacterDatabase.CreateStatement(insProgress, "INSERT INTO character_achievement_progress (guid, criteria, counter, date) VALUES (?, ?, ?, ?)");
+        static SqlStatementID replaceRow;
+        static SqlStatementID replaceRows;
+        SqlBatchInsert replaceStmt(CharacterDatabase, replaceRow, replaceRows, "REPLACE INTO character_achievement_progress (guid, criteria, counter, date) VALUES ", 4);
 
         // insert achievements
         for (CriteriaProgressMap::iterator iter = m_criteriaProgress.begin(); iter != m_criteriaProgress.end(); ++iter)
@@ -592,9 +591,6 @@ void AchievementMgr::SaveToDB()
             /// mark as updated in db
             iter->second.changed = false;
 
-            // new/changed record data
-            delStmt.PExecute(GetPlayer()->GetGUIDLow(), iter->first);
-
             bool needSave = iter->second.counter != 0;
             if (!needSave)
             {
@@ -602,8 +598,11 @@ void AchievementMgr::SaveToDB()
                 needSave = criteria && criteria->timeLimit > 0;
             }
 
+            // new/changed record data
             if (needSave)
-                insStmt.PExecute(GetPlayer()->GetGUIDLow(), iter->first, iter->second.counter, uint64(iter->second.date));
+                replaceStmt.AddRow(GetPlayer()->GetGUIDLow(), iter->first, iter->second.counter, uint64(iter->second.date));
+            else
+                delStmt.PExecute(GetPlayer()->GetGUIDLow(), iter->first);
         }
     }
 }
@@ -64,6 +64,24 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
     if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
         return;
 
+    // while grid regions are updated in parallel, grids more than one grid away from the own region
+    // belong to other threads: limit the search to the region grid and its neighbours
+    CellPair region_low(0, 0);
+    CellPair region_high(TOTAL_NUMBER_OF_CELLS_PER_MAP - 1, TOTAL_NUMBER_OF_CELLS_PER_MAP - 1);
+    if (MapRegion const* region = MapRegionUpdater::GetRegion(&m))
+    {
+        uint32 grid_x = region->grid / MAX_NUMBER_OF_GRIDS;
+        uint32 grid_y = region->grid % MAX_NUMBER_OF_GRIDS;
+        region_low.x_coord = grid_x > 0 ? (grid_x - 1) * MAX_NUMBER_OF_CELLS : 0;
+        region_low.y_coord = grid_y > 0 ? (grid_y - 1) * MAX_NUMBER_OF_CELLS : 0;
+        region_high.x_coord = std::min<uint32>((grid_x + 2) * MAX_NUMBER_OF_CELLS, TOTAL_NUMBER_OF_CELLS_PER_MAP) - 1;
+        region_high.y_coord = std::min<uint32>((grid_y + 2) * MAX_NUMBER_OF_CELLS, TOTAL_NUMBER_OF_CELLS_PER_MAP) - 1;
+
+        if (standing_cell.x_coord < region_low.x_coord || standing_cell.x_coord > region_high.x_coord ||
+            standing_cell.y_coord < region_low.y_coord || standing_cell.y_coord > region_high.y_coord)
+            return;
+    }
+
     // no jokes here... Actually placing ASSERT() here was good idea, but
     // we had some problems with DynamicObjects, which pass radius = 0.0f (DB issue?)
     // maybe it is better to just return when radius <= 0.0f?
@@ -87,6 +105,10 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
 
     CellPair& begin_cell = area.low_bound;
     CellPair& end_cell = area.high_bound;
+    begin_cell.x_coord = std::max(begin_cell.x_coord, region_low.x_coord);
+    begin_cell.y_coord = std::max(begin_cell.y_coord, region_low.y_coord);
+    end_cell.x_coord = std::min(end_cell.x_coord, region_high.x_coord);
+    end_cell.y_coord = std::min(end_cell.y_coord, region_high.y_coord);
     // visit all cells, found in CalculateCellArea()
     // if radius is known to reach cell area more than 4x4 then we should call optimized VisitCircle
     // currently this technique works with MAX_NUMBER_OF_CELLS 16 and higher, with lower values
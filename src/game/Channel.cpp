@@ -681,10 +681,12 @@ void Channel::SetOwner(ObjectGuid guid, bool exclaim)
 
 void Channel::SendToAll(WorldPacket* data, ObjectGuid guid)
 {
+    WorldPacketBroadcast broadcast(*data);
+
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
         if (Player* plr = sObjectMgr.GetPlayer(i->first))
             if (!guid || !plr->GetSocial()->HasIgnore(guid))
-                plr->GetSession()->SendPacket(data);
+                broadcast.SendTo(plr->GetSession());
 }
 
 void Channel::SendToOne(WorldPacket* data, ObjectGuid who)
@@ -517,6 +517,7 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleSendMassMoneyCommand(char* args);
 
         bool HandleServerCorpsesCommand(char* args);
+        bool HandleServerDBStatsCommand(char* args);
         bool HandleServerExitCommand(char* args);
         bool HandleServerIdleRestartCommand(char* args);
         bool HandleServerIdleShutDownCommand(char* args);
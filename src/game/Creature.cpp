@@ -173,6 +173,17 @@ void Creature::AddToWorld()
     // Not one time call this "added to world" creatures, spawned with negative spawn time (BG events mostly)
     if (GetVehicleKit())
         GetVehicleKit()->Reset();
+
+    if (GetScriptId())
+        GetMap()->AddScriptedCreature(this);
+}
+
+void Creature::RemoveFromWorld(bool remove)
+{
+    if (IsInWorld())
+        GetMap()->RemoveScriptedCreature(this);
+
+    Unit::RemoveFromWorld(remove);
 }
 
 void Creature::RemoveCorpse()
@@ -206,7 +217,10 @@ void Creature::RemoveCorpse()
         GetMap()->GetCreatureLinkingHolder()->DoCreatureLinkingEvent(LINKING_EVENT_DESPAWN, this);
 
     if (InstanceData* mapInstance = GetInstanceData())
+    {
+        Map::ScriptGuard guard(*GetMap());
         mapInstance->OnCreatureDespawn(this);
+    }
 
     // script can set time (in seconds) explicit, override the original
     if (respawnDelay)
@@ -840,7 +854,10 @@ bool Creature::Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo cons
     // Only works if you create the object in it, not if it is moves to that map.
     // Normally non-players do not teleport to other maps.
     if (InstanceData* iData = GetMap()->GetInstanceData())
+    {
+        Map::ScriptGuard guard(*GetMap());
         iData->OnCreatureCreate(this);
+    }
 
     switch (GetCreatureInfo()->Rank)
     {
@@ -929,6 +929,7 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
                 return;
             }
 
+            Map::ScriptGuard guard(*m_creature->GetMap());
             pInst->SetData(action.set_inst_data.field, action.set_inst_data.value);
             break;
         }
@@ -949,6 +950,7 @@ void CreatureEventAI::ProcessAction(CreatureEventAI_Action const& action, uint32
                 return;
             }
 
+            Map::ScriptGuard guard(*m_creature->GetMap());
             pInst->SetData64(action.set_inst_data64.field, target->GetObjectGuid().GetRawValue());
             break;
         }
@@ -234,7 +234,10 @@ bool GameObject::Create(uint32 guidlow, uint32 name_id, Map* map, uint32 phaseMa
     // Only works if you create the object in it, not if it is moves to that map.
     // Normally non-players do not teleport to other maps.
     if (InstanceData* iData = map->GetInstanceData())
+    {
+        Map::ScriptGuard guard(*map);
         iData->OnObjectCreate(this);
+    }
 
     // Notify the battleground/OPvP scripts
     if (map->IsBattleGroundOrArena())
@@ -24,11 +24,14 @@
 #include "DBCStores.h"
 #include "GridMap.h"
 #include "VMapFactory.h"
+#include "MapTree.h"
 #include "MoveMap.h"
 #include "World.h"
 #include "Policies/Singleton.h"
 #include "Util.h"
 
+#include <boost/bind.hpp>
+
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "v1.3";
 char const* MAP_AREA_MAGIC    = "AREA";
@@ -691,6 +694,7 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
         {
             m_GridMaps[i][k] = NULL;
             m_GridRef[i][k] = 0;
+            m_PrefetchedMaps[i][k] = NULL;
         }
     }
 
@@ -707,7 +711,10 @@ TerrainInfo::~TerrainInfo()
 {
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
         for (int i = 0; i < MAX_NUMBER_OF_GRIDS; ++i)
+        {
             delete m_GridMaps[i][k];
+            delete m_PrefetchedMaps[i][k];
+        }
 
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
@@ -752,10 +759,27 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    // terrain loader thread may publish prefetched grids meanwhile
+    LOCK_GUARD lock(m_mutex);
+
     for (int y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
     {
         for (int x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
         {
+            // drop prefetched grids not loaded since the previous clean up
+            if (GridMap* pPrefetched = m_PrefetchedMaps[x][y])
+            {
+                const uint32 idx = x * MAX_NUMBER_OF_GRIDS + y;
+                if (m_prefetchAged.test(idx))
+                {
+                    m_PrefetchedMaps[x][y] = NULL;
+                    m_prefetchAged.reset(idx);
+                    delete pPrefetched;
+                }
+                else
+                    m_prefetchAged.set(idx);
+            }
+
             const int16& iRef = m_GridRef[x][y];
             GridMap* pMap = m_GridMaps[x][y];
 
@@ -1183,21 +1207,17 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
-
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
-
-            if (!map->loadData(tmp))
+            // take over the grid parsed by the terrain loader if any
+            GridMap* map = m_PrefetchedMaps[x][y];
+            if (map)
             {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
+                m_PrefetchedMaps[x][y] = NULL;
+                m_prefetchAged.reset(x * MAX_NUMBER_OF_GRIDS + y);
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Using prefetched map %03u%02u%02u", m_mapId, x, y);
             }
+            else
+                map = CreateGridMap(x, y);
 
-            delete[] tmp;
             m_GridMaps[x][y] = map;
 
             // load VMAPs for current map/grid...
@@ -1226,6 +1246,133 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
     return  m_GridMaps[x][y];
 }
 
+GridMap* TerrainInfo::CreateGridMap(const uint32 x, const uint32 y) const
+{
+    GridMap* map = new GridMap();
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
+void TerrainInfo::Prefetch(float x, float y)
+{
+    if (!sTerrainMgr.IsPrefetchActive())
+        return;
+
+    int gx = (int)(32 - x / SIZE_OF_GRIDS);                 // grid x
+    int gy = (int)(32 - y / SIZE_OF_GRIDS);                 // grid y
+    if (gx < 0 || gx >= MAX_NUMBER_OF_GRIDS || gy < 0 || gy >= MAX_NUMBER_OF_GRIDS)
+        return;
+
+    // quick check if GridMap already loaded
+    if (m_GridMaps[gx][gy])
+        return;
+
+    const uint32 idx = gx * MAX_NUMBER_OF_GRIDS + gy;
+    {
+        LOCK_GUARD lock(m_mutex);
+        if (m_GridMaps[gx][gy] || m_PrefetchedMaps[gx][gy] || m_prefetchQueued.test(idx))
+            return;
+
+        m_prefetchQueued.set(idx);
+    }
+
+    if (!sTerrainMgr.QueuePrefetch(this, gx, gy))
+    {
+        LOCK_GUARD lock(m_mutex);
+        m_prefetchQueued.reset(idx);
+    }
+}
+
+void TerrainInfo::PrefetchAhead(float fromX, float fromY, float toX, float toY)
+{
+    float distance = sWorld.getConfig(CONFIG_FLOAT_GRID_PREFETCH_DISTANCE);
+    if (distance <= 0.0f || !sTerrainMgr.IsPrefetchActive())
+        return;
+
+    float dx = toX - fromX;
+    float dy = toY - fromY;
+    float length = sqrt(dx * dx + dy * dy);
+    if (length < 0.1f)
+        return;
+
+    dx /= length;
+    dy /= length;
+
+    // half grid steps, a grid only clipped at a corner is left to the synchronous load
+    const float step = SIZE_OF_GRIDS / 2;
+    for (float dist = step; dist <= distance; dist += step)
+        Prefetch(toX + dx * dist, toY + dy * dist);
+}
+
+// read a file once so the later load by the map thread is served from the OS file cache
+static void ReadAheadFile(std::string const& filename)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return;
+
+    std::vector<char> buffer(64 * 1024);
+    while (fread(&buffer[0], 1, buffer.size(), file) == buffer.size()) {}
+
+    fclose(file);
+}
+
+void TerrainInfo::LoadPrefetched(const uint32 x, const uint32 y)
+{
+    const uint32 idx = x * MAX_NUMBER_OF_GRIDS + y;
+
+    bool loaded;
+    {
+        LOCK_GUARD lock(m_mutex);
+        loaded = m_GridMaps[x][y] != NULL;
+    }
+
+    // file reading and parsing are done without lock, map threads keep using the loaded grids
+    GridMap* map = NULL;
+    if (!loaded)
+    {
+        map = CreateGridMap(x, y);
+
+        if (VMAP::VMapFactory::createOrGetVMapManager()->isMapLoadingEnabled())
+            ReadAheadFile(sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(m_mapId, x, y));
+
+        if (MMAP::MMapFactory::IsPathfindingEnabled(m_mapId))
+        {
+            char tileName[32];
+            snprintf(tileName, sizeof(tileName), "mmaps/%03u%02u%02u.mmtile", m_mapId, x, y);
+            ReadAheadFile(sWorld.GetDataPath() + tileName);
+        }
+    }
+
+    LOCK_GUARD lock(m_mutex);
+    m_prefetchQueued.reset(idx);
+
+    if (!map)
+        return;
+
+    // loaded by a map thread meanwhile
+    if (m_GridMaps[x][y] || m_PrefetchedMaps[x][y])
+    {
+        delete map;
+        return;
+    }
+
+    m_PrefetchedMaps[x][y] = map;
+}
+
 float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= NULL*/) const
 {
     if (const_cast<TerrainInfo*>(this)->GetGrid(x, y))
@@ -1253,12 +1400,113 @@ float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= N
 INSTANTIATE_SINGLETON_2(TerrainManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(TerrainManager, boost::mutex);
 
+// limits memory of prefetched grids when players move faster than the disk
+#define MAX_TERRAIN_PREFETCH_QUEUE 64
+
+TerrainLoader::TerrainLoader() : m_thread(NULL), m_current(NULL), m_stopping(false)
+{
+}
+
+TerrainLoader::~TerrainLoader()
+{
+    Deactivate();
+}
+
+void TerrainLoader::Activate()
+{
+    MANGOS_ASSERT(!IsActivated());
+
+    m_stopping = false;
+    m_thread = new boost::thread(boost::bind(&TerrainLoader::WorkerThread, this));
+
+    sLog.outString("TerrainLoader: background terrain loading started");
+}
+
+void TerrainLoader::Deactivate()
+{
+    if (!IsActivated())
+        return;
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    m_requestCondition.notify_all();
+
+    m_thread->join();
+    delete m_thread;
+    m_thread = NULL;
+}
+
+bool TerrainLoader::Queue(TerrainInfo* terrain, uint32 x, uint32 y)
+{
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        if (!m_thread || m_stopping || m_queue.size() >= MAX_TERRAIN_PREFETCH_QUEUE)
+            return false;
+
+        m_queue.push_back(PrefetchRequest(terrain, x, y));
+    }
+    m_requestCondition.notify_one();
+    return true;
+}
+
+void TerrainLoader::Discard(TerrainInfo* terrain)
+{
+    boost::unique_lock<boost::mutex> guard(m_mutex);
+
+    for (RequestQueue::iterator itr = m_queue.begin(); itr != m_queue.end();)
+    {
+        if (itr->m_terrain == terrain)
+            itr = m_queue.erase(itr);
+        else
+            ++itr;
+    }
+
+    while (m_current == terrain)
+        m_doneCondition.wait(guard);
+}
+
+void TerrainLoader::WorkerThread()
+{
+    for (;;)
+    {
+        PrefetchRequest request;
+
+        {
+            boost::unique_lock<boost::mutex> guard(m_mutex);
+            while (m_queue.empty() && !m_stopping)
+                m_requestCondition.wait(guard);
+
+            if (m_stopping)
+                return;
+
+            request = m_queue.front();
+            m_queue.pop_front();
+            m_current = request.m_terrain;
+        }
+
+        request.m_terrain->LoadPrefetched(request.m_x, request.m_y);
+
+        {
+            boost::lock_guard<boost::mutex> guard(m_mutex);
+            m_current = NULL;
+        }
+        m_doneCondition.notify_all();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 TerrainManager::TerrainManager()
 {
 }
 
 TerrainManager::~TerrainManager()
 {
+    m_loader.Deactivate();
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
         delete it->second;
 }
@@ -1294,12 +1542,19 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
         // lets check if this object can be actually freed
         if (ptr->IsReferenced() == false)
         {
+            m_loader.Discard(ptr);
             i_TerrainMap.erase(iter);
             delete ptr;
         }
     }
 }
 
+void TerrainManager::Initialize()
+{
+    if (sWorld.getConfig(CONFIG_FLOAT_GRID_PREFETCH_DISTANCE) > 0.0f && !m_loader.IsActivated())
+        m_loader.Activate();
+}
+
 void TerrainManager::Update(const uint32 diff)
 {
     // global garbage collection for GridMap objects and VMaps
@@ -1309,6 +1564,8 @@ void TerrainManager::Update(const uint32 diff)
 
 void TerrainManager::UnloadAll()
 {
+    m_loader.Deactivate();
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
         delete it->second;
 
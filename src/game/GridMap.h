@@ -27,10 +27,14 @@
 #include "SharedDefines.h"
 
 #include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_guard.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/noncopyable.hpp>
 
 #include <bitset>
+#include <deque>
 #include <list>
 
 class Creature;
@@ -247,6 +251,11 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<boost::atomic_long>
         bool GetAreaInfo(float x, float y, float z, uint32& mogpflags, int32& adtId, int32& rootId, int32& groupId) const;
         bool IsOutdoors(float x, float y, float z) const;
 
+        // queue the grid at x,y for the background terrain loader
+        void Prefetch(float x, float y);
+        // queue the grids up to GridPrefetchDistance ahead of a move from -> to
+        void PrefetchAhead(float fromX, float fromY, float toX, float toY);
+
         // this method should be used only by TerrainManager
         // to cleanup unreferenced GridMap objects - they are too heavy
         // to destroy them dynamically, especially on highly populated servers
@@ -259,12 +268,17 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<boost::atomic_long>
         GridMap* Load(const uint32 x, const uint32 y);
         void Unload(const uint32 x, const uint32 y);
 
+        friend class TerrainLoader;
+        // called by the terrain loader thread, the parsed grid is taken over by LoadMapAndVMap
+        void LoadPrefetched(const uint32 x, const uint32 y);
+
     private:
         TerrainInfo(const TerrainInfo&);
         TerrainInfo& operator=(const TerrainInfo&);
 
         GridMap* GetGrid(const float x, const float y);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        GridMap* CreateGridMap(const uint32 x, const uint32 y) const;
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -274,6 +288,12 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<boost::atomic_long>
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        // grids parsed by the terrain loader and not yet loaded, guarded by m_mutex
+        GridMap* m_PrefetchedMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        typedef std::bitset<MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> GridBits;
+        GridBits m_prefetchQueued;
+        GridBits m_prefetchAged;                            // prefetched grids already seen by CleanUpGrids
+
         // global garbage collection timer
         ShortIntervalTimer i_timer;
 
@@ -283,6 +303,57 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<boost::atomic_long>
         LOCK_TYPE m_refMutex;
 };
 
+/**
+ * Background thread reading terrain of grids ahead of moving players.
+ *
+ * Requests come from TerrainInfo::Prefetch, the thread parses the grid map file and reads the
+ * vmap and mmap tiles once so they are in the OS file cache. VMapManager2 and MMapManager are
+ * not thread safe, their tiles are still added by the map thread in TerrainInfo::LoadMapAndVMap,
+ * which also takes over the parsed GridMap instead of reading the file.
+ */
+class TerrainLoader : public boost::noncopyable
+{
+    public:
+        TerrainLoader();
+        ~TerrainLoader();
+
+        /// Start the loader thread
+        void Activate();
+        /// Stop and join the thread, queued requests are dropped
+        void Deactivate();
+        bool IsActivated() const { return m_thread != NULL; }
+
+        /// Queue a grid, false if the loader is stopped or the queue is full
+        bool Queue(TerrainInfo* terrain, uint32 x, uint32 y);
+        /// Drop requests of a terrain about to be deleted and wait for the one in progress
+        void Discard(TerrainInfo* terrain);
+
+    private:
+        struct PrefetchRequest
+        {
+            PrefetchRequest() : m_terrain(NULL), m_x(0), m_y(0) {}
+            PrefetchRequest(TerrainInfo* terrain, uint32 x, uint32 y) : m_terrain(terrain), m_x(x), m_y(y) {}
+
+            TerrainInfo* m_terrain;
+            uint32 m_x;
+            uint32 m_y;
+        };
+
+        typedef std::deque<PrefetchRequest> RequestQueue;
+
+        void WorkerThread();
+
+        RequestQueue m_queue;
+        boost::thread* m_thread;
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_requestCondition;       ///< signaled when new request queued or loader stopping
+        boost::condition_variable m_doneCondition;          ///< signaled when a request is done
+
+        TerrainInfo* m_current;                             ///< terrain of the request in progress
+        bool m_stopping;
+};
+
 // class for managing TerrainData object and all sort of geometry querying operations
 class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLevelLockable<TerrainManager, boost::mutex> >
 {
@@ -296,6 +367,11 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
         void Update(const uint32 diff);
         void UnloadAll();
 
+        // start the background terrain loader if GridPrefetchDistance is set
+        void Initialize();
+        bool IsPrefetchActive() const { return m_loader.IsActivated(); }
+        bool QueuePrefetch(TerrainInfo* terrain, uint32 x, uint32 y) { return m_loader.Queue(terrain, x, y); }
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
@@ -327,6 +403,7 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
 
         typedef MaNGOS::ClassLevelLockable<TerrainManager, boost::mutex>::Lock Guard;
         TerrainDataMap i_TerrainMap;
+        TerrainLoader m_loader;
 };
 
 #define sTerrainMgr TerrainManager::Instance()
@@ -565,13 +565,14 @@ void Guild::BroadcastToGuild(WorldSession* session, const std::string& msg, uint
     {
         WorldPacket data;
         ChatHandler::BuildChatPacket(data, CHAT_MSG_GUILD, msg.c_str(), Language(language), session->GetPlayer()->GetChatTag(), session->GetPlayer()->GetObjectGuid(), session->GetPlayer()->GetName());
+        WorldPacketBroadcast broadcast(data);
 
         for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
         {
             Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
 
             if (pl && pl->GetSession() && HasRankRight(pl->GetRank(), GR_RIGHT_GCHATLISTEN) && !pl->GetSocial()->HasIgnore(session->GetPlayer()->GetObjectGuid()))
-                pl->GetSession()->SendPacket(&data);
+                broadcast.SendTo(pl->GetSession());
         }
     }
 }
@@ -595,23 +596,27 @@ void Guild::BroadcastToOfficers(WorldSession* session, const std::string& msg, u
 
 void Guild::BroadcastPacket(WorldPacket* packet)
 {
+    WorldPacketBroadcast broadcast(*packet);
+
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
         if (player)
-            player->GetSession()->SendPacket(packet);
+            broadcast.SendTo(player->GetSession());
     }
 }
 
 void Guild::BroadcastPacketToRank(WorldPacket* packet, uint32 rankId)
 {
+    WorldPacketBroadcast broadcast(*packet);
+
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         if (itr->second.RankId == rankId)
         {
             Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
             if (player)
-                player->GetSession()->SendPacket(packet);
+                broadcast.SendTo(player->GetSession());
         }
     }
 }
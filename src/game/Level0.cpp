@@ -30,6 +30,7 @@
 #include "revision.h"
 #include "revision_nr.h"
 #include "Util.h"
+#include "WorldPacketPool.h"
 
 #include "boost/version.hpp"
 
@@ -121,6 +122,14 @@ bool ChatHandler::HandleServerInfoCommand(char* /*args*/)
     PSendSysMessage(LANG_CONNECTED_USERS, activeClientsNum, maxActiveClientsNum, queuedClientsNum, maxQueuedClientsNum);
     PSendSysMessage(LANG_UPTIME, str.c_str());
 
+    if (!m_session || m_session->GetSecurity() > SEC_PLAYER)
+    {
+        uint64 poolHits, poolMisses;
+        WorldPacketPool::GetStats(poolHits, poolMisses);
+        PSendSysMessage("Incoming packet pool: hits " UI64FMTD ", misses " UI64FMTD, poolHits, poolMisses);
+        PSendSysMessage("Character DB async queue: %u requests", sWorld.GetCharacterDBQueueSize());
+    }
+
     return true;
 }
 
@@ -6283,6 +6283,34 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerDBStatsCommand(char* args)
+{
+    if (*args)
+    {
+        if (!ExtractLiteralArg(&args, "reset"))
+            return false;
+
+        sWorld.ResetDatabaseMetrics();
+        SendSysMessage("Database metrics reset.");
+        return true;
+    }
+
+    if (!sWorld.getConfig(CONFIG_BOOL_DB_METRICS))
+    {
+        SendSysMessage("Database metrics are disabled, enable them with DatabaseMetrics in the config file.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    sWorld.GetDatabaseMetricsReport(lines, 10);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+        SendSysMessage(itr->c_str());
+
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
@@ -0,0 +1,170 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadGraph.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "ProgressBar.h"
+#include "Timer.h"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+void LoadGraph::AddStage(char const* name, LoadFunction function, char const* dependsOn1, char const* dependsOn2)
+{
+    MANGOS_ASSERT(FindStage(name) == m_stages.size());
+
+    size_t index = m_stages.size();
+    m_stages.push_back(Stage(name, function));
+
+    char const* dependsOn[] = { dependsOn1, dependsOn2 };
+    for (size_t i = 0; i < countof(dependsOn); ++i)
+    {
+        if (!dependsOn[i])
+            continue;
+
+        size_t dependency = FindStage(dependsOn[i]);
+        if (dependency == index)
+        {
+            sLog.outError("LoadGraph %s: stage '%s' depends on unknown or not yet added stage '%s'", m_name.c_str(), name, dependsOn[i]);
+            MANGOS_ASSERT(false);
+        }
+
+        m_stages[dependency].dependents.push_back(index);
+        ++m_stages[index].pending;
+    }
+}
+
+size_t LoadGraph::FindStage(char const* name) const
+{
+    for (size_t i = 0; i < m_stages.size(); ++i)
+        if (strcmp(m_stages[i].name, name) == 0)
+            return i;
+
+    return m_stages.size();
+}
+
+void LoadGraph::RunStage(Stage& stage)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+    stage.function();
+    stage.time = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+}
+
+void LoadGraph::Run(uint32 threads)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (threads > m_stages.size())
+        threads = m_stages.size();
+
+    if (threads <= 1)
+    {
+        for (Stages::iterator itr = m_stages.begin(); itr != m_stages.end(); ++itr)
+            RunStage(*itr);
+    }
+    else
+    {
+        m_ready.clear();
+        m_running = 0;
+        m_finished = 0;
+
+        // stages are pushed in reverse so the workers take them in declaration order
+        for (size_t i = m_stages.size(); i > 0; --i)
+            if (m_stages[i - 1].pending == 0)
+                m_ready.push_back(i - 1);
+
+        // concurrent progress bars would overwrite each other
+        bool showProgress = BarGoLink::GetOutputState();
+        BarGoLink::SetOutputState(false);
+
+        sLog.outString("Loading %s with %u threads...", m_name.c_str(), threads);
+
+        std::vector<boost::thread*> workers;
+        for (uint32 i = 0; i < threads; ++i)
+            workers.push_back(new boost::thread(boost::bind(&LoadGraph::WorkerThread, this)));
+
+        for (std::vector<boost::thread*>::iterator itr = workers.begin(); itr != workers.end(); ++itr)
+        {
+            (*itr)->join();
+            delete *itr;
+        }
+
+        BarGoLink::SetOutputState(showProgress);
+    }
+
+    ReportTimes(WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+}
+
+void LoadGraph::WorkerThread()
+{
+    WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
+
+    boost::unique_lock<boost::mutex> guard(m_mutex);
+    for (;;)
+    {
+        while (m_ready.empty() && m_finished < m_stages.size())
+        {
+            // nothing ready and nothing running would mean a stage was never released
+            MANGOS_ASSERT(m_running > 0);
+            m_condition.wait(guard);
+        }
+
+        if (m_finished == m_stages.size())
+            break;
+
+        size_t index = m_ready.back();
+        m_ready.pop_back();
+        ++m_running;
+
+        guard.unlock();
+        RunStage(m_stages[index]);
+        guard.lock();
+
+        --m_running;
+        ++m_finished;
+
+        std::vector<size_t> const& dependents = m_stages[index].dependents;
+        for (size_t i = 0; i < dependents.size(); ++i)
+            if (--m_stages[dependents[i]].pending == 0)
+                m_ready.insert(m_ready.begin(), dependents[i]);
+
+        m_condition.notify_all();
+    }
+    guard.unlock();
+
+    WorldDatabase.ThreadEnd();                              // free mySQL thread resources
+}
+
+void LoadGraph::ReportTimes(uint32 totalTime) const
+{
+    std::vector<std::pair<uint32, char const*> > times;
+    uint32 sumTime = 0;
+    for (Stages::const_iterator itr = m_stages.begin(); itr != m_stages.end(); ++itr)
+    {
+        times.push_back(std::make_pair(itr->time, itr->name));
+        sumTime += itr->time;
+    }
+
+    std::sort(times.begin(), times.end(), std::greater<std::pair<uint32, char const*> >());
+
+    sLog.outString();
+    sLog.outString(">>> %s loaded in %u ms (%u ms sum of stages)", m_name.c_str(), totalTime, sumTime);
+    for (size_t i = 0; i < times.size(); ++i)
+        sLog.outString("    %-40s %7u ms", times[i].second, times[i].first);
+    sLog.outString();
+}
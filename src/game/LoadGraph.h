@@ -0,0 +1,80 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOADGRAPH_H
+#define MANGOS_LOADGRAPH_H
+
+#include "Common.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * Runs a set of startup loading stages with explicit dependencies.
+ *
+ * A stage starts only after all stages it depends on are finished. Dependencies must be
+ * added before the stage depending on them, so the declaration order is always a valid
+ * sequential order and cycles can't be expressed. With one thread the stages run in
+ * declaration order on the calling thread, otherwise independent stages run in parallel
+ * on worker threads, each doing its database requests on its own query connection pick.
+ *
+ * Stages touching the same mutable state (script maps, locale index, ...) must depend
+ * on each other even without a data dependency.
+ */
+class LoadGraph
+{
+    public:
+        typedef void (*LoadFunction)();
+
+        explicit LoadGraph(char const* name) : m_name(name), m_running(0), m_finished(0) {}
+
+        /// Add a stage, dependsOn are names of already added stages
+        void AddStage(char const* name, LoadFunction function, char const* dependsOn1 = NULL, char const* dependsOn2 = NULL);
+
+        /// Run all stages and return when all of them are finished, logs per stage timings
+        void Run(uint32 threads);
+
+    private:
+        struct Stage
+        {
+            Stage(char const* name, LoadFunction function) : name(name), function(function), pending(0), time(0) {}
+
+            char const* name;
+            LoadFunction function;
+            std::vector<size_t> dependents;                 ///< stages waiting for this one
+            uint32 pending;                                 ///< not finished dependencies, guarded by m_mutex while running
+            uint32 time;                                    ///< execution time in ms
+        };
+
+        typedef std::vector<Stage> Stages;
+
+        size_t FindStage(char const* name) const;
+        void RunStage(Stage& stage);
+        void WorkerThread();
+        void ReportTimes(uint32 totalTime) const;
+
+        std::string m_name;
+        Stages m_stages;
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_condition;              ///< signaled when stages get ready or all are finished
+        std::vector<size_t> m_ready;                        ///< stages with finished dependencies, not started yet
+        size_t m_running;
+        size_t m_finished;
+};
+
+#endif
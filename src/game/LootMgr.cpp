@@ -100,12 +100,19 @@ void LootStore::LoadLootTable()
 
     sLog.outString("%s :", GetName());
 
-    //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
+    uint32 recordCount = 0;
+    if (QueryResult* result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", GetName()))
+    {
+        recordCount = result->Fetch()[0].GetUInt32();
+        delete result;
+    }
+
+    //                                                         0      1     2                    3        4              5         6
+    QueryResult* result = WorldDatabase.PQueryStreamed("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
 
     if (result)
     {
-        BarGoLink bar(result->GetRowCount());
+        BarGoLink bar(recordCount);
 
         do
         {
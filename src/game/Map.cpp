@@ -80,7 +80,8 @@ void Map::LoadMapAndVMap(int gx,int gy)
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
-  : i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
+  : m_regionUpdateActive(false),
+  i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
   i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
   m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
   m_TerrainData(sTerrainMgr.LoadTerrain(id)),
@@ -273,6 +274,8 @@ void Map::setUnitCell(Creature* obj)
 void
 Map::EnsureGridCreated(const GridPair &p)
 {
+    RegionGuard guard(*this);
+
     if (!getNGridWithoutLock(p.x_coord, p.y_coord))
     {
         // Grid may be created while wait in semafore, requires double check
@@ -325,6 +328,10 @@ Map::EnsureGridLoadedAtEnter(Cell const& cell, Player* player)
 
 bool Map::EnsureGridLoaded(Cell const& cell)
 {
+    // loaded objects call instance data hooks
+    ScriptGuard scriptGuard(*this);
+    RegionGuard guard(*this);
+
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType const* cgrid = getNGridWithoutLock(cell.GridX(), cell.GridY());
 
@@ -440,6 +447,17 @@ bool Map::Add(Player* player)
     return true;
 }
 
+// grids of same phase are at least 2 grids apart, so nothing in them can reach the cells of other regions
+static inline uint32 GetRegionPhase(CellPair const& cell)
+{
+    return (cell.x_coord / MAX_NUMBER_OF_CELLS) % 3 * 3 + (cell.y_coord / MAX_NUMBER_OF_CELLS) % 3;
+}
+
+static inline uint32 GetRegionGrid(CellPair const& cell)
+{
+    return (cell.x_coord / MAX_NUMBER_OF_CELLS) * MAX_NUMBER_OF_GRIDS + cell.y_coord / MAX_NUMBER_OF_CELLS;
+}
+
 template<class T>
 void
 Map::Add(T* obj)
@@ -453,6 +471,11 @@ Map::Add(T* obj)
         return;
     }
 
+    // grids of other regions are updated by other threads right now, the object enters the world
+    // at once and is added to its grid after the phase (see ApplyDeferredOps)
+    MapRegion* region = MapRegionUpdater::GetRegion(this);
+    bool deferGrid = region && GetRegionGrid(p) != region->grid;
+
     if (FindObject(obj->GetObjectGuid()))
     {
         if (obj->GetObjectGuid().IsCreatureOrVehicle())
@@ -478,18 +501,59 @@ Map::Add(T* obj)
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
     MANGOS_ASSERT(grid != NULL);
 
-    AddToGrid(obj,grid,cell);
+    if (!deferGrid)
+        AddToGrid(obj,grid,cell);
     obj->AddToWorld();
 
     if(obj->isActiveObject())
         AddToActive(obj);
 
+    if (deferGrid)
+    {
+        region->deferred.addObjects.push_back(obj);
+        return;
+    }
+
     DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Map::Add map %u instance %u add %s to grid [%u,%u]", GetId(), GetInstanceId(), obj->GetObjectGuid() ? obj->GetObjectGuid().GetString().c_str() : "<no GUID>", cell.GridX(), cell.GridY());
 
     obj->GetViewPoint().Event_AddedToWorld(&(*grid)(cell.CellX(), cell.CellY()));
     UpdateObjectVisibility(obj,cell,p);
 }
 
+/// Second part of Add for objects added from another grid region, see Map::Add
+template<class T>
+void Map::AddDeferredToGrid(T* obj)
+{
+    // removed again before the end of the phase
+    if (!obj->IsInWorld())
+        return;
+
+    CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
+    Cell cell(p);
+    EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
+    NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
+    MANGOS_ASSERT(grid != NULL);
+
+    AddToGrid(obj, grid, cell);
+
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Map::Add map %u instance %u add %s to grid [%u,%u] after region update", GetId(), GetInstanceId(), obj->GetObjectGuid().GetString().c_str(), cell.GridX(), cell.GridY());
+
+    obj->GetViewPoint().Event_AddedToWorld(&(*grid)(cell.CellX(), cell.CellY()));
+    UpdateObjectVisibility(obj, cell, p);
+}
+
+void Map::AddScriptedCreature(Creature* creature)
+{
+    RegionGuard guard(*this);
+    m_scriptedCreatures.insert(creature);
+}
+
+void Map::RemoveScriptedCreature(Creature* creature)
+{
+    RegionGuard guard(*this);
+    m_scriptedCreatures.erase(creature);
+}
+
 void Map::MessageBroadcast(Player const* player, WorldPacket* msg, bool to_self)
 {
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
@@ -619,115 +683,81 @@ void Map::Update(const uint32 &t_diff)
         delete loadingObject;
     }
 
-    /// update worldsessions for existing players (stage 1)
-    GuidQueue updateQueue = GetActiveObjects();
-    while (!updateQueue.empty())
-    {
-        ObjectGuid guid = updateQueue.front();
-        updateQueue.pop();
-
-        if (!guid.IsPlayer())
-            continue;
-
-        Player* plr = GetPlayer(guid);
-
-        if (plr && plr->IsInWorld())
-        {
-            if (WorldSession* pSession = plr->GetSession())
-            {
-                MapSessionFilter updater(pSession);
-                pSession->Update(updater);
-                // sending WorldState updates
-                plr->SendUpdatedWorldStates(false);
-            }
-        }
-    }
+    /// update worldsessions, active objects (players also) and cells around them in one pass
+    resetMarkedCells();
 
-    /// update active objects (players also) at tick (stage 2)
-    /*GuidQueue*/ updateQueue = GetActiveObjects();
-    while (!updateQueue.empty())
+    bool hasActive = !m_activeObjects.empty();
     {
-        ObjectGuid guid = updateQueue.front();
-        updateQueue.pop();
-
-        WorldObject* obj = GetWorldObject(guid);
-        if (!obj || !obj->IsInWorld())
-            continue;
-
-        switch (guid.GetHigh())
+        MapActiveObjects::Iteration activeObjects(m_activeObjects);
+        for (size_t i = 0; i < activeObjects.GetCount(); ++i)
         {
-            case HIGHGUID_PLAYER:
+            WorldObject* obj = activeObjects.GetObject(i);
+            if (!obj || !obj->IsInWorld())
+                continue;
+
+            switch (obj->GetObjectGuid().GetHigh())
             {
-                Player* plr = dynamic_cast<Player*>(obj);
-                if (plr)
+                case HIGHGUID_PLAYER:
                 {
+                    Player* plr = (Player*)obj;
+                    if (WorldSession* pSession = plr->GetSession())
+                    {
+                        MapSessionFilter updater(pSession);
+                        pSession->Update(updater);
+                        // sending WorldState updates
+                        plr->SendUpdatedWorldStates(false);
+                    }
+
+                    // session update can remove player from map
+                    if (activeObjects.GetObject(i) != obj || !obj->IsInWorld())
+                        continue;
+
                     WorldObject::UpdateHelper helper(*plr);
                     helper.Update(t_diff);
+                    break;
                 }
-                break;
-            }
-            case HIGHGUID_MO_TRANSPORT:
-            {
-                // update active MO_TRANSPORT objects
-                if (obj->isActiveObject() && obj->IsPositionValid())
+                case HIGHGUID_MO_TRANSPORT:
                 {
-                    WorldObject::UpdateHelper helper(*obj);
-                    helper.Update(t_diff);
+                    // update active MO_TRANSPORT objects
+                    if (obj->isActiveObject() && obj->IsPositionValid())
+                    {
+                        WorldObject::UpdateHelper helper(*obj);
+                        helper.Update(t_diff);
+                    }
+                    break;
                 }
-                break;
+                case HIGHGUID_TRANSPORT:
+                // updating regular transports (after fully implementing Transport:: (NOT MOTransport!) class)
+                default:
+                // All another objects (active and not active) be updated in TypeContainerVisitor<> expressions
+                    break;
             }
-            case HIGHGUID_TRANSPORT:
-            // updating regular transports (after fully implementing Transport:: (NOT MOTransport!) class)
-            default:
-            // All another objects (active and not active) be updated in TypeContainerVisitor<> expressions
-                break;
-        }
-    }
 
-    /// update active cells around players and active objects
-    resetMarkedCells();
-
-    MaNGOS::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
-
-    // player and non-player active objects (only cells re-mark)
-    /*GuidQueue*/ updateQueue = GetActiveObjects();
-    bool hasActive = !updateQueue.empty();
-    while (!updateQueue.empty())
-    {
-        ObjectGuid guid = updateQueue.front();
-        updateQueue.pop();
-
-        WorldObject* obj = GetWorldObject(guid);
-
-        if (!obj || !obj->IsInWorld() || !obj->isActiveObject() || !obj->IsPositionValid())
-            continue;
+            // update can remove object from map too
+            if (activeObjects.GetObject(i) != obj || !obj->IsInWorld() || !obj->isActiveObject() || !obj->IsPositionValid())
+                continue;
 
-        //lets update mobs/objects in ALL visible cells around player!
-        CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
-        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-        {
-            for(uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            //lets update mobs/objects in ALL visible cells around player!
+            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
             {
-                // marked cells are those that have been visited
-                // don't visit the same cell twice
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if(!isCellMarked(cell_id))
+                for(uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
                 {
-                    markCell(cell_id);
-                    CellPair pair(x,y);
-                    Cell cell(pair);
-                    cell.SetNoCreate();
-                    Visit(cell, grid_object_update);
-                    Visit(cell, world_object_update);
+                    // marked cells are those that have been visited
+                    // don't visit the same cell twice
+                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+                    if(!isCellMarked(cell_id))
+                    {
+                        markCell(cell_id);
+                        m_regionCells.push_back(CellPair(x, y));
+                    }
                 }
             }
         }
     }
 
+    UpdateMarkedCells(t_diff);
+
     // Send world objects and item update field changes
     if (hasActive)
         SendObjectUpdates();
@@ -759,6 +789,125 @@ void Map::Update(const uint32 &t_diff)
     m_weatherSystem->UpdateWeathers(t_diff);
 }
 
+void Map::UpdateCells(MapRegionCells const& cells, size_t first, size_t last, uint32 diff)
+{
+    MaNGOS::ObjectUpdater updater(diff);
+    // for creature
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    // for pets
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for (size_t i = first; i < last; ++i)
+    {
+        Cell cell(cells[i]);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
+    }
+}
+
+struct RegionCellOrder
+{
+    bool operator()(CellPair const& a, CellPair const& b) const
+    {
+        uint32 phaseA = GetRegionPhase(a);
+        uint32 phaseB = GetRegionPhase(b);
+        return phaseA != phaseB ? phaseA < phaseB : GetRegionGrid(a) < GetRegionGrid(b);
+    }
+};
+
+void Map::UpdateMarkedCells(uint32 diff)
+{
+    MapRegionUpdater& regionUpdater = sMapMgr.GetRegionUpdater();
+    if (!regionUpdater.IsActivated())
+    {
+        UpdateCells(m_regionCells, 0, m_regionCells.size(), diff);
+        m_regionCells.clear();
+        return;
+    }
+
+    // cells of one grid form a region, keep visit order inside of region
+    std::stable_sort(m_regionCells.begin(), m_regionCells.end(), RegionCellOrder());
+
+    // regions with scripted creatures are updated under the script lock, see ScriptGuard
+    m_scriptedGrids.reset();
+    for (std::set<Creature*>::const_iterator itr = m_scriptedCreatures.begin(); itr != m_scriptedCreatures.end(); ++itr)
+    {
+        CellPair p = MaNGOS::ComputeCellPair((*itr)->GetPositionX(), (*itr)->GetPositionY());
+        if (p.x_coord < TOTAL_NUMBER_OF_CELLS_PER_MAP && p.y_coord < TOTAL_NUMBER_OF_CELLS_PER_MAP)
+            m_scriptedGrids.set(GetRegionGrid(p));
+    }
+
+    size_t cellCount = m_regionCells.size();
+    for (size_t phaseStart = 0; phaseStart < cellCount;)
+    {
+        uint32 phase = GetRegionPhase(m_regionCells[phaseStart]);
+
+        m_regions.clear();
+        size_t i = phaseStart;
+        while (i < cellCount && GetRegionPhase(m_regionCells[i]) == phase)
+        {
+            size_t regionStart = i;
+            uint32 grid = GetRegionGrid(m_regionCells[i]);
+            while (i < cellCount && GetRegionGrid(m_regionCells[i]) == grid)
+                ++i;
+
+            m_regions.push_back(MapRegion(regionStart, i, grid, m_scriptedGrids.test(grid)));
+        }
+        phaseStart = i;
+
+        // single region, nothing to share with other threads
+        if (m_regions.size() == 1)
+        {
+            UpdateCells(m_regionCells, m_regions[0].firstCell, m_regions[0].lastCell, diff);
+            continue;
+        }
+
+        m_regionUpdateActive = true;
+        regionUpdater.UpdateRegions(*this, m_regionCells, m_regions, diff);
+        m_regionUpdateActive = false;
+
+        for (MapRegionList::iterator itr = m_regions.begin(); itr != m_regions.end(); ++itr)
+            ApplyDeferredOps(itr->deferred);
+    }
+
+    m_regions.clear();
+    m_regionCells.clear();
+}
+
+void Map::ApplyDeferredOps(MapDeferredOps& ops)
+{
+    for (MapDeferredOps::AddObjectOps::const_iterator itr = ops.addObjects.begin(); itr != ops.addObjects.end(); ++itr)
+    {
+        switch ((*itr)->GetTypeId())
+        {
+            case TYPEID_UNIT:          AddDeferredToGrid(static_cast<Creature*>(*itr)); break;
+            case TYPEID_GAMEOBJECT:    AddDeferredToGrid(static_cast<GameObject*>(*itr)); break;
+            case TYPEID_DYNAMICOBJECT: AddDeferredToGrid(static_cast<DynamicObject*>(*itr)); break;
+            case TYPEID_CORPSE:        AddDeferredToGrid(static_cast<Corpse*>(*itr)); break;
+            default:                   break;
+        }
+    }
+
+    for (MapDeferredOps::UpdateObjectOps::const_iterator itr = ops.updateObjects.begin(); itr != ops.updateObjects.end(); ++itr)
+    {
+        if (itr->second)
+            i_objectsToClientUpdate.insert(itr->first);
+        else
+            i_objectsToClientUpdate.erase(itr->first);
+    }
+
+    for (MapDeferredOps::RemoveListOps::const_iterator itr = ops.removeList.begin(); itr != ops.removeList.end(); ++itr)
+    {
+        if (itr->second)
+            i_objectsToRemove.insert(itr->first);
+        else
+            i_objectsToRemove.erase(itr->first);
+    }
+
+    ops.clear();
+}
+
 void Map::Remove(Player* player, bool remove)
 {
     if (!FindObject(player->GetObjectGuid()))
@@ -888,7 +1037,10 @@ void Map::Relocation(Player* player, Position const& pos)
 {
     MANGOS_ASSERT(player);
 
-    CellPair old_val = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
+    float old_x = player->GetPositionX();
+    float old_y = player->GetPositionY();
+
+    CellPair old_val = MaNGOS::ComputeCellPair(old_x, old_y);
     CellPair new_val = MaNGOS::ComputeCellPair(pos.x, pos.y);
 
     Cell old_cell(old_val);
@@ -915,12 +1067,24 @@ void Map::Relocation(Player* player, Position const& pos)
     player->OnRelocated();
 
     if (!same_cell)
+    {
         ActivateGrid(getNGrid(new_cell.GridX(), new_cell.GridY()));
+
+        // let the terrain loader read grids the player is heading to
+        GetTerrain()->PrefetchAhead(old_x, old_y, pos.x, pos.y);
+    }
 };
 
 template<>
 void Map::Relocation(Creature* creature, Position const& pos)
 {
+    // added from another grid region in this update phase, enters its cell in ApplyDeferredOps
+    if (!creature->GetGridRef().isValid())
+    {
+        creature->Relocate(pos);
+        return;
+    }
+
     MANGOS_ASSERT(CheckGridIntegrity(creature,false));
 
 //    Cell old_cell = creature->GetCurrentCell();
@@ -1098,6 +1262,8 @@ void Map::UnloadAll(bool pForce)
 
 void Map::AddLoadingObject(LoadingObjectQueueMember* obj)
 {
+    RegionGuard guard(*this);
+
     i_loadingObjectQueue.push(obj);
 }
 
@@ -1199,31 +1365,28 @@ void Map::SendInitActiveObjects(Player* player)
     if (!player)
         return;
 
-    GuidQueue updateQueue = GetActiveObjects();
-    if (updateQueue.empty())
+    if (m_activeObjects.empty())
         return;
 
     UpdateData initData = UpdateData();
     bool hasAny = false;
 
-    while(!updateQueue.empty())
+    MapActiveObjects::Iteration activeObjects(m_activeObjects);
+    for (size_t i = 0; i < activeObjects.GetCount(); ++i)
     {
-        ObjectGuid guid = updateQueue.front();
-        updateQueue.pop();
+        WorldObject* object = activeObjects.GetObject(i);
 
-        if (guid.IsPlayer())
+        if (!object || object->GetTypeId() == TYPEID_PLAYER)
             continue;
 
-        WorldObject* object = GetWorldObject(guid);
-
-        if (!object || !object->IsInWorld() || !object->isVisibleForInState(player,player,false) || !object->isActiveObject())
+        if (!object->IsInWorld() || !object->isVisibleForInState(player,player,false) || !object->isActiveObject())
             continue;
 
         object->BuildCreateUpdateBlockForPlayer(&initData, player);
         object->AddNotifiedClient(player->GetObjectGuid());
         hasAny = true;
         DEBUG_FILTER_LOG(LOG_FILTER_VISIBILITY_CHANGES, "Map::SendInitActiveObjects %s visibility initialized for %s",
-                      guid.GetString().c_str(), player->GetGuidStr().c_str());
+                      object->GetGuidStr().c_str(), player->GetGuidStr().c_str());
     }
     if (!hasAny)
         return;
@@ -1238,31 +1401,28 @@ void Map::SendRemoveActiveObjects(Player* player)
     if (!player)
         return;
 
-    GuidQueue updateQueue = GetActiveObjects();
-    if (updateQueue.empty())
+    if (m_activeObjects.empty())
         return;
 
     UpdateData initData = UpdateData();
     bool hasAny = false;
 
-    while(!updateQueue.empty())
+    MapActiveObjects::Iteration activeObjects(m_activeObjects);
+    for (size_t i = 0; i < activeObjects.GetCount(); ++i)
     {
-        ObjectGuid guid = updateQueue.front();
-        updateQueue.pop();
+        WorldObject* object = activeObjects.GetObject(i);
 
-        if (guid.IsPlayer())
+        if (!object || object->GetTypeId() == TYPEID_PLAYER)
             continue;
 
-        WorldObject* object = GetWorldObject(guid);
-
-        if (!object || !object->IsInWorld() || !object->isActiveObject())
+        if (!object->IsInWorld() || !object->isActiveObject())
             continue;
 
         object->BuildOutOfRangeUpdateBlock(&initData);
         hasAny = true;
         object->RemoveNotifiedClient(player->GetObjectGuid());
         DEBUG_FILTER_LOG(LOG_FILTER_VISIBILITY_CHANGES, "Map::SendRemoveActiveObjects %s visibility removed for %s",
-                    guid.GetString().c_str(), player->GetGuidStr().c_str());
+                    object->GetGuidStr().c_str(), player->GetGuidStr().c_str());
     }
     if (!hasAny)
         return;
@@ -1288,12 +1448,24 @@ void Map::AddObjectToRemoveList(WorldObject* obj, bool immediateCleanup)
 
     obj->CleanupsBeforeDelete();                                // remove or simplify at least cross referenced links
 
+    if (MapDeferredOps* deferred = MapRegionUpdater::GetDeferredOps(this))
+    {
+        deferred->removeList.push_back(std::make_pair(obj, true));
+        return;
+    }
+
     i_objectsToRemove.insert(obj);
     //DEBUG_LOG("Object (GUID: %u TypeId: %u ) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
 
 void Map::RemoveObjectFromRemoveList(WorldObject* obj)
 {
+    if (MapDeferredOps* deferred = MapRegionUpdater::GetDeferredOps(this))
+    {
+        deferred->removeList.push_back(std::make_pair(obj, false));
+        return;
+    }
+
     if (!i_objectsToRemove.empty())
         i_objectsToRemove.erase(obj);
 }
@@ -1366,16 +1538,13 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
     cell_max >> cell_range;
     cell_max += cell_range;
 
-    GuidQueue updateQueue = const_cast<Map*>(this)->GetActiveObjects();
-    if (updateQueue.empty())
+    if (m_activeObjects.empty())
         return false;
 
-    while(!updateQueue.empty())
+    MapActiveObjects::Iteration activeObjects(const_cast<MapActiveObjects&>(m_activeObjects));
+    for (size_t i = 0; i < activeObjects.GetCount(); ++i)
     {
-        ObjectGuid guid = updateQueue.front();
-        updateQueue.pop();
-
-        WorldObject const* obj = const_cast<Map*>(this)->GetWorldObject(guid);
+        WorldObject const* obj = activeObjects.GetObject(i);
         if (!obj || !obj->isActiveObject())
             continue;
 
@@ -1390,10 +1559,14 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    // can load grids, see EnsureGridLoaded
+    ScriptGuard scriptGuard(*this);
+    RegionGuard guard(*this);
+
     if (!obj)
         return;
 
-    m_activeObjects.insert(obj->GetObjectGuid());
+    m_activeObjects.insert(obj);
 
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoadedAtEnter(cell, obj->GetTypeId() == TYPEID_PLAYER ? (Player*)obj : NULL);
@@ -1445,6 +1618,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    RegionGuard guard(*this);
+
     if (!obj)
         return;
 
@@ -1942,6 +2117,8 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
 {
     MANGOS_ASSERT(source);
 
+    RegionGuard guard(*this);
+
     ///- Find the script map
     ScriptMapMap::const_iterator s = scripts.second.find(id);
     if (s == scripts.second.end())
@@ -1981,6 +2158,8 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
 
 void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
 {
+    RegionGuard guard(*this);
+
     // NOTE: script record _must_ exist until command executed
 
     // prepare static data
@@ -2057,6 +2236,13 @@ void Map::InsertObject(WorldObject* object)
     if (!object)
         return;
 
+    if (m_regionUpdateActive)
+    {
+        boost::unique_lock<boost::shared_mutex> guard(m_objectsStoreLock);
+        m_objectsStore.insert(MapStoredObjectTypesContainer::value_type(object->GetObjectGuid(), object));
+        return;
+    }
+
     m_objectsStore.insert(MapStoredObjectTypesContainer::value_type(object->GetObjectGuid(), object));
 }
 
@@ -2073,6 +2259,19 @@ void Map::EraseObject(ObjectGuid const& guid)
     if (guid.IsEmpty())
         return;
 
+    // deleted object can't stay in active objects (grid unload doesn't call RemoveFromActive)
+    {
+        RegionGuard guard(*this);
+        m_activeObjects.erase(guid);
+    }
+
+    if (m_regionUpdateActive)
+    {
+        boost::unique_lock<boost::shared_mutex> guard(m_objectsStoreLock);
+        m_objectsStore.erase(guid);
+        return;
+    }
+
     m_objectsStore.erase(guid);
 }
 
@@ -2081,6 +2280,13 @@ WorldObject* Map::FindObject(ObjectGuid const& guid)
     if (guid.IsEmpty())
         return NULL;
 
+    if (m_regionUpdateActive)
+    {
+        boost::shared_lock<boost::shared_mutex> guard(m_objectsStoreLock);
+        MapStoredObjectTypesContainer::iterator itr = m_objectsStore.find(guid);
+        return (itr == m_objectsStore.end()) ? NULL : itr->second;
+    }
+
     MapStoredObjectTypesContainer::iterator itr = m_objectsStore.find(guid);
     return (itr == m_objectsStore.end()) ? NULL : itr->second;
 }
@@ -2233,12 +2439,18 @@ WorldObject* Map::GetWorldObject(ObjectGuid const& guid)
 
 void Map::AddUpdateObject(ObjectGuid const& guid)
 {
-    i_objectsToClientUpdate.insert(guid);
+    if (MapDeferredOps* deferred = MapRegionUpdater::GetDeferredOps(this))
+        deferred->updateObjects.push_back(std::make_pair(guid, true));
+    else
+        i_objectsToClientUpdate.insert(guid);
 }
 
 void Map::RemoveUpdateObject(ObjectGuid const& guid)
 {
-    i_objectsToClientUpdate.erase(guid);
+    if (MapDeferredOps* deferred = MapRegionUpdater::GetDeferredOps(this))
+        deferred->updateObjects.push_back(std::make_pair(guid, false));
+    else
+        i_objectsToClientUpdate.erase(guid);
 }
 
 ObjectGuid Map::GetNextObjectFromUpdateQueue()
@@ -2293,6 +2505,8 @@ void Map::SendObjectUpdates()
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
+    RegionGuard guard(*this);
+
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
     switch(guidhigh)
     {
@@ -2438,6 +2652,8 @@ void Map::UpdateWorldState(uint32 state, uint32 value)
 
 void Map::AddAttackerFor(ObjectGuid const& targetGuid, ObjectGuid const& attackerGuid)
 {
+    RegionGuard guard(*this);
+
     if (targetGuid.IsEmpty() || attackerGuid.IsEmpty())
         return;
 
@@ -2455,6 +2671,8 @@ void Map::AddAttackerFor(ObjectGuid const& targetGuid, ObjectGuid const& attacke
 
 void Map::RemoveAttackerFor(ObjectGuid const& targetGuid, ObjectGuid const& attackerGuid)
 {
+    RegionGuard guard(*this);
+
     if (targetGuid.IsEmpty() || attackerGuid.IsEmpty())
         return;
 
@@ -2467,6 +2685,8 @@ void Map::RemoveAttackerFor(ObjectGuid const& targetGuid, ObjectGuid const& atta
 
 void Map::RemoveAllAttackersFor(ObjectGuid const& targetGuid)
 {
+    RegionGuard guard(*this);
+
     if (targetGuid.IsEmpty())
         return;
 
@@ -2493,6 +2713,8 @@ bool Map::IsInCombat(ObjectGuid const& targetGuid) const
 
 void Map::CreateAttackersStorageFor(ObjectGuid const& targetGuid)
 {
+    RegionGuard guard(*this);
+
     if (targetGuid.IsEmpty())
         return;
 
@@ -2506,6 +2728,8 @@ void Map::CreateAttackersStorageFor(ObjectGuid const& targetGuid)
 
 void Map::RemoveAttackersStorageFor(ObjectGuid const& targetGuid)
 {
+    RegionGuard guard(*this);
+
     if (targetGuid.IsEmpty())
         return;
 
@@ -2621,6 +2845,7 @@ bool Map::GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float
     }
     // at second all dynamic objects, if static check has an hit, then we can calculate only to this point and NOT to end, because we need closely hit point
 
+    DynamicTreeReadGuard dynTreeGuard(*this);
     bool result1 = GetDynamicMapTree().getObjectHitPos(phasemask, srcX, srcY, srcZ, destX, destY, destZ, tempX, tempY, tempZ, modifyDist);
     if (result1)
     {
@@ -2639,6 +2864,7 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z) const
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
 
+    DynamicTreeReadGuard dynTreeGuard(*this);
     return std::max<float>(staticHeight, GetDynamicMapTree().getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask));
 }
 
@@ -2693,22 +2919,32 @@ bool Map::GetHeightInRange(uint32 phasemask, float x, float y, float &z, float m
             return false;
     }
 
+    DynamicTreeReadGuard dynTreeGuard(*this);
     z = std::max<float>(height, m_dyn_tree.getHeight(x, y, height + 1.0f, maxSearchDist, phasemask));
     return true;
 }
 
 void Map::InsertGameObjectModel(GameObjectModel const& mdl)
 {
+    boost::unique_lock<boost::shared_mutex> guard(m_dynTreeLock, boost::defer_lock);
+    if (m_regionUpdateActive)
+        guard.lock();
+
     m_dyn_tree.insert(mdl);
 }
 
 void Map::RemoveGameObjectModel(GameObjectModel const& mdl)
 {
+    boost::unique_lock<boost::shared_mutex> guard(m_dynTreeLock, boost::defer_lock);
+    if (m_regionUpdateActive)
+        guard.lock();
+
     m_dyn_tree.remove(mdl);
 }
 
 bool Map::ContainsGameObjectModel(GameObjectModel const& mdl) const
 {
+    DynamicTreeReadGuard dynTreeGuard(*this);
     return GetDynamicMapTree().contains(mdl);
 }
 
@@ -2724,6 +2960,7 @@ void Map::DynamicMapTreeUpdate(uint32 const& t_diff)
 
 bool Map::IsInLineOfSightByDynamicMapTree(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask) const
 {
+    DynamicTreeReadGuard dynTreeGuard(*this);
     return GetDynamicMapTree().isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
 }
 
@@ -2871,12 +3108,63 @@ bool Map::UpdateGridState(NGridType& grid, GridInfo& info, uint32 const& t_diff)
     return true;
 }
 
-GuidQueue Map::GetActiveObjects()
+bool MapActiveObjects::insert(WorldObject* obj)
+{
+    if (!m_index.insert(SlotIndex::value_type(obj->GetObjectGuid(), m_objects.size())).second)
+        return false;
+
+    m_objects.push_back(obj);
+    return true;
+}
+
+bool MapActiveObjects::erase(ObjectGuid const& guid)
+{
+    SlotIndex::iterator itr = m_index.find(guid);
+    if (itr == m_index.end())
+        return false;
+
+    size_t slot = itr->second;
+    m_index.erase(itr);
+
+    // keep slots stable for running iterations
+    if (m_iterations)
+    {
+        m_objects[slot] = NULL;
+        ++m_removed;
+        return true;
+    }
+
+    if (slot + 1 != m_objects.size())
+    {
+        m_objects[slot] = m_objects.back();
+        m_index[m_objects[slot]->GetObjectGuid()] = slot;
+    }
+    m_objects.pop_back();
+    return true;
+}
+
+void MapActiveObjects::EndIteration()
 {
-    GuidQueue result;
-    for (GuidSet::const_iterator itr = m_activeObjects.begin(); itr != m_activeObjects.end(); ++itr)
-        result.push(*itr);
-    return result;
+    if (--m_iterations || !m_removed)
+        return;
+
+    size_t used = 0;
+    for (size_t slot = 0; slot < m_objects.size(); ++slot)
+    {
+        WorldObject* obj = m_objects[slot];
+        if (!obj)
+            continue;
+
+        if (used != slot)
+        {
+            m_objects[used] = obj;
+            m_index[obj->GetObjectGuid()] = used;
+        }
+        ++used;
+    }
+
+    m_objects.resize(used);
+    m_removed = 0;
 }
 
 time_t Map::GetGridExpiry() const
@@ -37,9 +37,11 @@
 #include "ScriptMgr.h"
 #include "CreatureLinkingMgr.h"
 #include "vmap/DynamicTree.h"
+#include "MapRegionUpdater.h"
 
 #include <boost/thread/lock_guard.hpp>
 #include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 #include <bitset>
 #include <list>
@@ -181,11 +183,61 @@ class LoadingObjectsCompare
 
 typedef std::priority_queue<LoadingObjectQueueMember*, std::vector<LoadingObjectQueueMember*>, LoadingObjectsCompare> LoadingObjectsQueue;
 
+/**
+ * Storage of map active objects, safe for add/remove while iterated.
+ *
+ * Objects are kept in a vector in insertion order. Objects removed while an iteration is
+ * in progress only leave an empty slot, slots are compacted when the last iteration ends.
+ * Objects added while iterated are appended behind the iteration generation (count of
+ * objects at iteration start) and get visited by the next one. No allocation per iteration.
+ */
+class MapActiveObjects
+{
+    public:
+        MapActiveObjects() : m_iterations(0), m_removed(0) {}
+
+        bool insert(WorldObject* obj);
+        bool erase(ObjectGuid const& guid);
+
+        bool empty() const { return m_index.empty(); }
+        size_t size() const { return m_index.size(); }
+
+        /// RAII iteration scope, object at slot is NULL if removed meanwhile
+        class Iteration
+        {
+            public:
+                explicit Iteration(MapActiveObjects& store) : m_store(store), m_count(store.m_objects.size()) { ++m_store.m_iterations; }
+                ~Iteration() { m_store.EndIteration(); }
+
+                size_t GetCount() const { return m_count; }
+                WorldObject* GetObject(size_t slot) const { return m_store.m_objects[slot]; }
+
+            private:
+                Iteration(Iteration const&);
+                Iteration& operator=(Iteration const&);
+
+                MapActiveObjects& m_store;
+                size_t m_count;
+        };
+
+    private:
+        typedef std::vector<WorldObject*> ObjectSlots;
+        typedef UNORDERED_MAP<ObjectGuid, size_t> SlotIndex;
+
+        void EndIteration();
+
+        ObjectSlots m_objects;
+        SlotIndex m_index;
+        uint32 m_iterations;                                // nested iterations in progress
+        uint32 m_removed;                                   // empty slots waiting for compaction
+};
+
 class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 {
     friend class MapReference;
     friend class ObjectGridLoader;
     friend class ObjectWorldLoader;
+    friend class MapRegionUpdater;
 
     protected:
         Map(uint32 id, time_t, uint32 InstanceId, uint8 SpawnMode);
@@ -342,7 +394,6 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         void AddToActive(WorldObject* obj);
         // must called with RemoveFromWorld
         void RemoveFromActive(WorldObject* obj);
-        GuidQueue GetActiveObjects();
 
         Player* GetPlayer(ObjectGuid const& guid, bool globalSearch = false);
         Creature* GetCreature(ObjectGuid  const& guid);
@@ -379,6 +430,22 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         InstanceData* GetInstanceData() const { return i_data; }
         uint32 GetScriptId() const { return i_script_id; }
 
+        // script code keeps map wide state without locks: while grid regions of this map are updated
+        // in parallel, regions with scripted creatures and all instance data hooks run one at a time.
+        // Taken before any RegionGuard of the map
+        class ScriptGuard
+        {
+            public:
+                explicit ScriptGuard(Map const& map) : m_lock(map.m_regionUpdateActive ? &map.m_scriptLock : NULL) { if (m_lock) m_lock->lock(); }
+                ~ScriptGuard() { if (m_lock) m_lock->unlock(); }
+            private:
+                boost::recursive_mutex* m_lock;
+        };
+
+        // creatures with script library AI, see ScriptGuard
+        void AddScriptedCreature(Creature* creature);
+        void RemoveScriptedCreature(Creature* creature);
+
         void MonsterYellToMap(ObjectGuid guid, int32 textId, Language language, Unit const* target) const;
         void MonsterYellToMap(CreatureInfo const* cinfo, int32 textId, Language language, Unit const* target, uint32 senderLowGuid = 0) const;
         void PlayDirectSoundToMap(uint32 soundId, uint32 zoneId = 0) const;
@@ -486,6 +553,42 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         void SendObjectUpdates();
 
+        // grid region update (see MapRegionUpdater)
+        void UpdateCells(MapRegionCells const& cells, size_t first, size_t last, uint32 diff);
+        void UpdateMarkedCells(uint32 diff);
+        void ApplyDeferredOps(MapDeferredOps& ops);
+        template<class T> void AddDeferredToGrid(T* obj);
+
+        // locks shared map state only while grid regions of this map are updated in parallel
+        class RegionGuard
+        {
+            public:
+                explicit RegionGuard(Map const& map) : m_lock(map.m_regionUpdateActive ? &map.m_regionLock : NULL) { if (m_lock) m_lock->lock(); }
+                ~RegionGuard() { if (m_lock) m_lock->unlock(); }
+            private:
+                boost::recursive_mutex* m_lock;
+        };
+
+        // dynamic tree readers, game object models are inserted/removed from all regions
+        class DynamicTreeReadGuard
+        {
+            public:
+                explicit DynamicTreeReadGuard(Map const& map) : m_lock(map.m_regionUpdateActive ? &map.m_dynTreeLock : NULL) { if (m_lock) m_lock->lock_shared(); }
+                ~DynamicTreeReadGuard() { if (m_lock) m_lock->unlock_shared(); }
+            private:
+                boost::shared_mutex* m_lock;
+        };
+
+        MapRegionCells m_regionCells;                       // marked cells of current update, sorted by region
+        MapRegionList m_regions;
+        bool m_regionUpdateActive;
+        mutable boost::recursive_mutex m_regionLock;
+        mutable boost::recursive_mutex m_scriptLock;        // see ScriptGuard
+        std::set<Creature*> m_scriptedCreatures;            // guarded by RegionGuard
+        std::bitset<MAX_NUMBER_OF_GRIDS * MAX_NUMBER_OF_GRIDS> m_scriptedGrids;
+        mutable boost::shared_mutex m_objectsStoreLock;     // used only while m_regionUpdateActive
+        mutable boost::shared_mutex m_dynTreeLock;          // used only while m_regionUpdateActive
+
         GuidSet i_objectsToClientUpdate;
 
         LoadingObjectsQueue i_loadingObjectQueue;
@@ -500,8 +603,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         MapRefManager m_mapRefManager;
 
-        GuidSet m_activeObjects;
-        GuidSet m_activeObjectsSafeCopy;
+        MapActiveObjects m_activeObjects;
         MapStoredObjectTypesContainer m_objectsStore;
 
     private:
@@ -38,11 +38,28 @@ MapManager::MapManager()
 
 MapManager::~MapManager()
 {
+    m_updater.Deactivate();
+    m_regionUpdater.Deactivate();
     m_maps.clear();
 }
 
 void MapManager::Initialize()
 {
+    SetMapUpdateThreads(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_THREADS));
+
+    if (uint32 gridThreads = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_GRID_THREADS))
+        m_regionUpdater.Activate(gridThreads);
+
+    sTerrainMgr.Initialize();
+}
+
+void MapManager::SetMapUpdateThreads(uint32 threads)
+{
+    // called only from world thread between map updates, so pool is idle here
+    m_updater.Deactivate();
+
+    if (threads > 0)
+        m_updater.Activate(threads);
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -172,8 +189,19 @@ void MapManager::Update(uint32 diff)
     if (!m_timer.Passed())
         return;
 
-    for (MapMapType::iterator iter = m_maps.begin(); iter != m_maps.end(); ++iter)
-        iter->second->Update((uint32)m_timer.GetCurrent());
+    if (m_updater.IsActivated())
+    {
+        for (MapMapType::iterator iter = m_maps.begin(); iter != m_maps.end(); ++iter)
+            m_updater.ScheduleUpdate(*iter->second, (uint32)m_timer.GetCurrent());
+
+        // barrier: no map may be in update when world thread continues
+        m_updater.Wait();
+    }
+    else
+    {
+        for (MapMapType::iterator iter = m_maps.begin(); iter != m_maps.end(); ++iter)
+            iter->second->Update((uint32)m_timer.GetCurrent());
+    }
 
     // remove all maps which can be unloaded
     for (MapMapType::const_iterator iter = m_maps.begin(); iter != m_maps.end();)
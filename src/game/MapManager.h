@@ -25,6 +25,7 @@
 #include <boost/thread/lock_guard.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 #include "Map.h"
+#include "MapUpdater.h"
 
 class BattleGround;
 
@@ -51,6 +52,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void Initialize(void);
         void Update(uint32);
 
+        // worker pool for parallel Map::Update calls, see MapUpdater
+        void SetMapUpdateThreads(uint32 threads);
+
+        // worker pool for parallel grid region updates inside of one map, see MapRegionUpdater
+        MapRegionUpdater& GetRegionUpdater() { return m_regionUpdater; }
+
         void SetMapUpdateInterval(uint32 t)
         {
             if (t < MIN_MAP_UPDATE_DELAY)
@@ -134,6 +141,8 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         MapMapType         m_maps;
         ShortIntervalTimer m_timer;
+        MapUpdater         m_updater;
+        MapRegionUpdater   m_regionUpdater;
 };
 
 template<typename Do>
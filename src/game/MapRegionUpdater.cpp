@@ -0,0 +1,210 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapRegionUpdater.h"
+#include "Map.h"
+#include "Log.h"
+#include <boost/bind.hpp>
+
+boost::thread_specific_ptr<MapRegionUpdater::RegionContext> MapRegionUpdater::m_context(&MapRegionUpdater::NoContextCleanup);
+
+MapRegionUpdater::MapRegionUpdater() : m_queuedTasks(0), m_nextQueue(0), m_stopping(false)
+{
+}
+
+MapRegionUpdater::~MapRegionUpdater()
+{
+    Deactivate();
+}
+
+void MapRegionUpdater::Activate(size_t num_threads)
+{
+    MANGOS_ASSERT(!IsActivated());
+
+    m_stopping = false;
+    for (size_t i = 0; i < num_threads; ++i)
+        m_queues.push_back(new WorkerQueue);
+
+    for (size_t i = 0; i < num_threads; ++i)
+        m_workers.push_back(new boost::thread(boost::bind(&MapRegionUpdater::WorkerThread, this, i)));
+
+    sLog.outString("MapRegionUpdater: %u grid region update threads started", uint32(num_threads));
+}
+
+void MapRegionUpdater::Deactivate()
+{
+    if (!IsActivated())
+        return;
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_stopping = true;
+    }
+    m_taskCondition.notify_all();
+
+    for (WorkerThreads::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+    {
+        (*itr)->join();
+        delete *itr;
+    }
+    m_workers.clear();
+
+    for (WorkerQueues::iterator itr = m_queues.begin(); itr != m_queues.end(); ++itr)
+        delete *itr;
+    m_queues.clear();
+}
+
+MapRegion* MapRegionUpdater::GetRegion(Map const* map)
+{
+    RegionContext* context = m_context.get();
+    return context && context->map == map ? context->region : NULL;
+}
+
+MapDeferredOps* MapRegionUpdater::GetDeferredOps(Map const* map)
+{
+    MapRegion* region = GetRegion(map);
+    return region ? &region->deferred : NULL;
+}
+
+void MapRegionUpdater::UpdateRegions(Map& map, MapRegionCells const& cells, MapRegionList& regions, uint32 diff)
+{
+    if (regions.empty())
+        return;
+
+    RegionBatch batch;
+    batch.map = &map;
+    batch.cells = &cells;
+    batch.regions = &regions;
+    batch.diff = diff;
+    batch.remaining = regions.size();
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_queuedTasks += regions.size();
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            WorkerQueue* queue = m_queues[m_nextQueue];
+            m_nextQueue = (m_nextQueue + 1) % m_queues.size();
+
+            boost::lock_guard<boost::mutex> queueGuard(queue->lock);
+            queue->tasks.push_back(RegionTask(&batch, i));
+        }
+    }
+    m_taskCondition.notify_all();
+
+    // help the workers instead of blocking, tasks of other maps are fine too
+    RegionTask task;
+    while (batch.remaining > 0)
+    {
+        if (StealTask(m_queues.size(), task))
+        {
+            Execute(task);
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> guard(m_mutex);
+        if (batch.remaining > 0 && m_queuedTasks == 0)
+            m_doneCondition.wait(guard);
+    }
+}
+
+bool MapRegionUpdater::PopTask(size_t index, RegionTask& task)
+{
+    WorkerQueue* queue = m_queues[index];
+    boost::lock_guard<boost::mutex> guard(queue->lock);
+    if (queue->tasks.empty())
+        return false;
+
+    // own queue is used LIFO, thieves take from the other end
+    task = queue->tasks.back();
+    queue->tasks.pop_back();
+    --m_queuedTasks;
+    return true;
+}
+
+bool MapRegionUpdater::StealTask(size_t thief, RegionTask& task)
+{
+    for (size_t i = 0; i < m_queues.size(); ++i)
+    {
+        if (i == thief)
+            continue;
+
+        WorkerQueue* queue = m_queues[i];
+        boost::lock_guard<boost::mutex> guard(queue->lock);
+        if (queue->tasks.empty())
+            continue;
+
+        task = queue->tasks.front();
+        queue->tasks.pop_front();
+        --m_queuedTasks;
+        return true;
+    }
+
+    return false;
+}
+
+void MapRegionUpdater::Execute(RegionTask const& task)
+{
+    RegionBatch* batch = task.batch;
+    MapRegion& region = (*batch->regions)[task.index];
+
+    RegionContext context;
+    context.map = batch->map;
+    context.region = &region;
+
+    // allow nested use: map owner thread can help with tasks while it has own context
+    RegionContext* prevContext = m_context.release();
+    m_context.reset(&context);
+
+    if (region.scripted)
+    {
+        Map::ScriptGuard guard(*batch->map);
+        batch->map->UpdateCells(*batch->cells, region.firstCell, region.lastCell, batch->diff);
+    }
+    else
+        batch->map->UpdateCells(*batch->cells, region.firstCell, region.lastCell, batch->diff);
+
+    m_context.release();
+    m_context.reset(prevContext);
+
+    if (--batch->remaining == 0)
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_doneCondition.notify_all();
+    }
+}
+
+void MapRegionUpdater::WorkerThread(size_t index)
+{
+    RegionTask task;
+    for (;;)
+    {
+        if (PopTask(index, task) || StealTask(index, task))
+        {
+            Execute(task);
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> guard(m_mutex);
+        if (m_stopping)
+            return;
+
+        if (m_queuedTasks == 0)
+            m_taskCondition.wait(guard);
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPREGIONUPDATER_H
+#define MANGOS_MAPREGIONUPDATER_H
+
+#include "Common.h"
+#include "GridDefines.h"
+#include "ObjectGuid.h"
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/noncopyable.hpp>
+#include <deque>
+
+class Map;
+class WorldObject;
+
+/// Map state changes done by a region update, applied by map owner thread after the phase
+struct MapDeferredOps
+{
+    typedef std::vector<std::pair<ObjectGuid, bool> > UpdateObjectOps;   // guid, add (true) or remove (false)
+    typedef std::vector<std::pair<WorldObject*, bool> > RemoveListOps;   // object, add (true) or remove (false)
+    typedef std::vector<WorldObject*> AddObjectOps;                       // objects added to grids of other regions
+
+    void clear() { updateObjects.clear(); removeList.clear(); addObjects.clear(); }
+
+    UpdateObjectOps updateObjects;
+    RemoveListOps removeList;
+    AddObjectOps addObjects;
+};
+
+/// Marked cells of one grid, updated as one task
+struct MapRegion
+{
+    MapRegion(size_t first, size_t last, uint32 gridId, bool hasScripts) : firstCell(first), lastCell(last), grid(gridId), scripted(hasScripts) {}
+
+    size_t firstCell;                                       ///< index of first cell in cell list
+    size_t lastCell;                                        ///< index after last cell in cell list
+    uint32 grid;                                            ///< grid x * MAX_NUMBER_OF_GRIDS + grid y
+    bool scripted;                                          ///< has creatures with script library AI, see Map::ScriptGuard
+    MapDeferredOps deferred;
+};
+
+typedef std::vector<CellPair> MapRegionCells;
+typedef std::vector<MapRegion> MapRegionList;
+
+/**
+ * Work-stealing pool updating grid regions of a single map in parallel.
+ *
+ * Map::Update splits the marked cells by grid and colors the grids with a 3x3 pattern,
+ * so grids updated at the same time are at least two grids apart and objects in them
+ * can't reach each other's cells. Every color is one phase: its regions are spread over
+ * the workers' queues, idle workers steal from the others and the map owner thread helps
+ * until the phase is done. Changes of shared map state (client update queue, remove list,
+ * objects added outside of the region's grid) are collected per region in MapDeferredOps
+ * and applied in region order after the phase.
+ */
+class MapRegionUpdater : public boost::noncopyable
+{
+    public:
+        MapRegionUpdater();
+        ~MapRegionUpdater();
+
+        /// Start num_threads workers, 0 disables region updates
+        void Activate(size_t num_threads);
+        void Deactivate();
+        bool IsActivated() const { return !m_workers.empty(); }
+
+        /// Update all regions of one phase and return when all of them are done
+        void UpdateRegions(Map& map, MapRegionCells const& cells, MapRegionList& regions, uint32 diff);
+
+        /// Region of map currently updated by this thread, or NULL
+        static MapRegion* GetRegion(Map const* map);
+        /// Deferred ops of region currently updated by this thread for map, or NULL
+        static MapDeferredOps* GetDeferredOps(Map const* map);
+
+    private:
+        struct RegionBatch
+        {
+            Map* map;
+            MapRegionCells const* cells;
+            MapRegionList* regions;
+            uint32 diff;
+            boost::atomic<size_t> remaining;
+        };
+
+        struct RegionTask
+        {
+            RegionTask() : batch(NULL), index(0) {}
+            RegionTask(RegionBatch* b, size_t i) : batch(b), index(i) {}
+
+            RegionBatch* batch;
+            size_t index;
+        };
+
+        struct WorkerQueue
+        {
+            boost::mutex lock;
+            std::deque<RegionTask> tasks;
+        };
+
+        struct RegionContext
+        {
+            Map const* map;
+            MapRegion* region;
+        };
+
+        typedef std::vector<WorkerQueue*> WorkerQueues;
+        typedef std::vector<boost::thread*> WorkerThreads;
+
+        static void NoContextCleanup(RegionContext*) {}    // context lives on Execute() stack
+
+        void WorkerThread(size_t index);
+        bool PopTask(size_t index, RegionTask& task);
+        bool StealTask(size_t thief, RegionTask& task);
+        void Execute(RegionTask const& task);
+
+        WorkerQueues m_queues;                              ///< one deque per worker, map owner threads only steal
+        WorkerThreads m_workers;
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_taskCondition;          ///< signaled when new tasks queued or pool stopping
+        boost::condition_variable m_doneCondition;          ///< signaled when a batch finished
+        boost::atomic<size_t> m_queuedTasks;
+        size_t m_nextQueue;
+        bool m_stopping;
+
+        static boost::thread_specific_ptr<RegionContext> m_context;
+};
+
+#endif
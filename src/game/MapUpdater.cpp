@@ -0,0 +1,113 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "Log.h"
+#include <boost/bind.hpp>
+
+MapUpdater::MapUpdater() : m_pendingRequests(0), m_stopping(false)
+{
+}
+
+MapUpdater::~MapUpdater()
+{
+    Deactivate();
+}
+
+void MapUpdater::Activate(size_t num_threads)
+{
+    MANGOS_ASSERT(!IsActivated());
+
+    m_stopping = false;
+    for (size_t i = 0; i < num_threads; ++i)
+        m_workerThreads.push_back(new boost::thread(boost::bind(&MapUpdater::WorkerThread, this)));
+
+    sLog.outString("MapUpdater: %u map update threads started", uint32(num_threads));
+}
+
+void MapUpdater::Deactivate()
+{
+    if (!IsActivated())
+        return;
+
+    Wait();
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_stopping = true;
+    }
+    m_requestCondition.notify_all();
+
+    for (WorkerThreads::iterator itr = m_workerThreads.begin(); itr != m_workerThreads.end(); ++itr)
+    {
+        (*itr)->join();
+        delete *itr;
+    }
+
+    m_workerThreads.clear();
+}
+
+void MapUpdater::ScheduleUpdate(Map& map, uint32 diff)
+{
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_queue.push(MapUpdateRequest(map, diff));
+        ++m_pendingRequests;
+    }
+    m_requestCondition.notify_one();
+}
+
+void MapUpdater::Wait()
+{
+    boost::unique_lock<boost::mutex> guard(m_mutex);
+    while (m_pendingRequests > 0)
+        m_finishedCondition.wait(guard);
+}
+
+void MapUpdater::UpdateFinished()
+{
+    boost::lock_guard<boost::mutex> guard(m_mutex);
+
+    MANGOS_ASSERT(m_pendingRequests > 0);
+    if (--m_pendingRequests == 0)
+        m_finishedCondition.notify_all();
+}
+
+void MapUpdater::WorkerThread()
+{
+    for (;;)
+    {
+        MapUpdateRequest request;
+
+        {
+            boost::unique_lock<boost::mutex> guard(m_mutex);
+            while (m_queue.empty() && !m_stopping)
+                m_requestCondition.wait(guard);
+
+            if (m_queue.empty())
+                return;                                     // stopping and nothing left to do
+
+            request = m_queue.front();
+            m_queue.pop();
+        }
+
+        request.m_map->Update(request.m_diff);
+        UpdateFinished();
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/noncopyable.hpp>
+#include <queue>
+
+class Map;
+
+/**
+ * Worker pool used by MapManager to update maps in parallel.
+ *
+ * Every Map::Update call of a tick is scheduled as a separate task, Wait() is
+ * the barrier: it returns only after all scheduled maps finished their update.
+ * Nothing outside of Map::Update runs while the pool is busy, so everything
+ * that touches more than one map (far teleports, thread-unsafe opcodes in
+ * World::UpdateSessions, battleground/outdoor pvp managers) stays on the world thread.
+ */
+class MapUpdater : public boost::noncopyable
+{
+    public:
+        MapUpdater();
+        ~MapUpdater();
+
+        /// Start num_threads workers, 0 keeps map updates on the world thread
+        void Activate(size_t num_threads);
+        /// Stop and join all workers, pending requests are finished first
+        void Deactivate();
+        bool IsActivated() const { return !m_workerThreads.empty(); }
+
+        /// Queue Map::Update(diff) for execution on one of the workers
+        void ScheduleUpdate(Map& map, uint32 diff);
+        /// Block until all scheduled updates are done
+        void Wait();
+
+    private:
+        struct MapUpdateRequest
+        {
+            MapUpdateRequest() : m_map(NULL), m_diff(0) {}
+            MapUpdateRequest(Map& map, uint32 diff) : m_map(&map), m_diff(diff) {}
+
+            Map* m_map;
+            uint32 m_diff;
+        };
+
+        typedef std::queue<MapUpdateRequest> RequestQueue;
+        typedef std::vector<boost::thread*> WorkerThreads;
+
+        void WorkerThread();
+        void UpdateFinished();
+
+        RequestQueue m_queue;
+        WorkerThreads m_workerThreads;
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_requestCondition;       ///< signaled when new request queued or pool stopping
+        boost::condition_variable m_finishedCondition;      ///< signaled when last pending request done
+
+        size_t m_pendingRequests;                           ///< queued + currently executed requests
+        bool m_stopping;
+};
+
+#endif
@@ -1315,18 +1315,26 @@ void ObjectMgr::LoadCreatureModelRace()
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
-    //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
-                          //   4             5           6           7           8            9              10         11
-                          "equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, currentwaypoint,"
-                          //   12         13       14          15            16         17         18
-                          "curhealth, curmana, DeathState, MovementType, spawnMask, phaseMask, event,"
-                          //   19                        20
-                          "pool_creature.pool_entry, pool_creature_template.pool_entry "
-                          "FROM creature "
-                          "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
-                          "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid "
-                          "LEFT OUTER JOIN pool_creature_template ON creature.id = pool_creature_template.id");
+
+    uint32 recordCount = 0;
+    if (QueryResult* result = WorldDatabase.Query("SELECT COUNT(*) FROM creature"))
+    {
+        recordCount = result->Fetch()[0].GetUInt32();
+        delete result;
+    }
+
+    //                                                        0                       1   2    3
+    QueryResult* result = WorldDatabase.QueryStreamed("SELECT creature.guid, creature.id, map, modelid,"
+                                  //   4             5           6           7           8            9              10         11
+                                  "equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, currentwaypoint,"
+                                  //   12         13       14          15            16         17         18
+                                  "curhealth, curmana, DeathState, MovementType, spawnMask, phaseMask, event,"
+                                  //   19                        20
+                                  "pool_creature.pool_entry, pool_creature_template.pool_entry "
+                                  "FROM creature "
+                                  "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
+                                  "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid "
+                                  "LEFT OUTER JOIN pool_creature_template ON creature.id = pool_creature_template.id");
 
     if (!result)
     {
@@ -1353,7 +1361,7 @@ void ObjectMgr::LoadCreatures()
                 if (GetMapDifficultyData(i, Difficulty(k)))
                     spawnMasks[i] |= (1 << k);
 
-    BarGoLink bar(result->GetRowCount());
+    BarGoLink bar(recordCount);
 
     do
     {
@@ -1570,16 +1578,23 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 count = 0;
 
-    //                                                0                           1   2    3           4           5           6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
-                          //   7          8          9          10         11             12            13     14         15         16
-                          "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, phaseMask, event,"
-                          //   17                          18
-                          "pool_gameobject.pool_entry, pool_gameobject_template.pool_entry "
-                          "FROM gameobject "
-                          "LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid "
-                          "LEFT OUTER JOIN pool_gameobject ON gameobject.guid = pool_gameobject.guid "
-                          "LEFT OUTER JOIN pool_gameobject_template ON gameobject.id = pool_gameobject_template.id");
+    uint32 recordCount = 0;
+    if (QueryResult* result = WorldDatabase.Query("SELECT COUNT(*) FROM gameobject"))
+    {
+        recordCount = result->Fetch()[0].GetUInt32();
+        delete result;
+    }
+
+    //                                                        0                           1   2    3           4           5           6
+    QueryResult* result = WorldDatabase.QueryStreamed("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
+                                  //   7          8          9          10         11             12            13     14         15         16
+                                  "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, phaseMask, event,"
+                                  //   17                          18
+                                  "pool_gameobject.pool_entry, pool_gameobject_template.pool_entry "
+                                  "FROM gameobject "
+                                  "LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid "
+                                  "LEFT OUTER JOIN pool_gameobject ON gameobject.guid = pool_gameobject.guid "
+                                  "LEFT OUTER JOIN pool_gameobject_template ON gameobject.id = pool_gameobject_template.id");
 
     if (!result)
     {
@@ -1598,7 +1613,7 @@ void ObjectMgr::LoadGameObjects()
                 if (GetMapDifficultyData(i, Difficulty(k)))
                     spawnMasks[i] |= (1 << k);
 
-    BarGoLink bar(result->GetRowCount());
+    BarGoLink bar(recordCount);
 
     do
     {
@@ -1819,7 +1834,8 @@ bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
 
     uint32 lowguid = guid.GetCounter();
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT name FROM characters WHERE guid = '%u'", lowguid);
+    static SqlStatementID selName;
+    QueryResult* result = CharacterDatabase.CreateStatement(selName, "SELECT name FROM characters WHERE guid = ?").PQuery(lowguid);
 
     if (result)
     {
@@ -1839,7 +1855,8 @@ Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
 
     uint32 lowguid = guid.GetCounter();
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT race FROM characters WHERE guid = '%u'", lowguid);
+    static SqlStatementID selRace;
+    QueryResult* result = CharacterDatabase.CreateStatement(selRace, "SELECT race FROM characters WHERE guid = ?").PQuery(lowguid);
 
     if (result)
     {
@@ -1862,7 +1879,8 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
 
     uint32 lowguid = guid.GetCounter();
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE guid = '%u'", lowguid);
+    static SqlStatementID selAccount;
+    QueryResult* result = CharacterDatabase.CreateStatement(selAccount, "SELECT account FROM characters WHERE guid = ?").PQuery(lowguid);
     if (result)
     {
         uint32 acc = (*result)[0].GetUInt32();
@@ -1875,7 +1893,8 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
 
 uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
 {
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE name = '%s'", name.c_str());
+    static SqlStatementID selAccount;
+    QueryResult* result = CharacterDatabase.CreateStatement(selAccount, "SELECT account FROM characters WHERE name = ?").PQuery(name.c_str());
     if (result)
     {
         uint32 acc = (*result)[0].GetUInt32();
@@ -36,6 +36,7 @@
 #include "ObjectAccessor.h"
 #include "ObjectGuid.h"
 #include "Policies/Singleton.h"
+#include "Utilities/FlatHashMap.h"
 #include "Vehicle.h"
 
 #include <string>
@@ -161,7 +162,7 @@ struct MangosStringLocale
     uint32 Emote;
 };
 
-typedef UNORDERED_MAP<uint32 /*guid*/, CreatureData> CreatureDataMap;
+typedef FlatHashMap<uint32 /*guid*/, CreatureData> CreatureDataMap;
 typedef CreatureDataMap::value_type CreatureDataPair;
 
 class FindCreatureData
@@ -184,7 +185,7 @@ class FindCreatureData
         float i_spawnedDist;
 };
 
-typedef UNORDERED_MAP<uint32, GameObjectData> GameObjectDataMap;
+typedef FlatHashMap<uint32, GameObjectData> GameObjectDataMap;
 typedef GameObjectDataMap::value_type GameObjectDataPair;
 
 class FindGOData
@@ -207,15 +208,15 @@ class FindGOData
         float i_spawnedDist;
 };
 
-typedef UNORDERED_MAP<uint32, CreatureLocale> CreatureLocaleMap;
-typedef UNORDERED_MAP<uint32, GameObjectLocale> GameObjectLocaleMap;
-typedef UNORDERED_MAP<uint32, ItemLocale> ItemLocaleMap;
-typedef UNORDERED_MAP<uint32, QuestLocale> QuestLocaleMap;
-typedef UNORDERED_MAP<uint32, NpcTextLocale> NpcTextLocaleMap;
-typedef UNORDERED_MAP<uint32, PageTextLocale> PageTextLocaleMap;
-typedef UNORDERED_MAP<int32, MangosStringLocale> MangosStringLocaleMap;
-typedef UNORDERED_MAP<uint32, GossipMenuItemsLocale> GossipMenuItemsLocaleMap;
-typedef UNORDERED_MAP<uint32, PointOfInterestLocale> PointOfInterestLocaleMap;
+typedef FlatHashMap<uint32, CreatureLocale> CreatureLocaleMap;
+typedef FlatHashMap<uint32, GameObjectLocale> GameObjectLocaleMap;
+typedef FlatHashMap<uint32, ItemLocale> ItemLocaleMap;
+typedef FlatHashMap<uint32, QuestLocale> QuestLocaleMap;
+typedef FlatHashMap<uint32, NpcTextLocale> NpcTextLocaleMap;
+typedef FlatHashMap<uint32, PageTextLocale> PageTextLocaleMap;
+typedef FlatHashMap<int32, MangosStringLocale> MangosStringLocaleMap;
+typedef FlatHashMap<uint32, GossipMenuItemsLocale> GossipMenuItemsLocaleMap;
+typedef FlatHashMap<uint32, PointOfInterestLocale> PointOfInterestLocaleMap;
 typedef UNORDERED_MAP<uint32, uint32> ItemConvertMap;
 
 typedef std::multimap<int32, uint32> ExclusiveQuestGroupsMap;
@@ -0,0 +1,371 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PacketCapture.h"
+#include "WorldPacket.h"
+#include "SharedDefines.h"
+#include "Config/Config.h"
+#include "Log.h"
+#include "Util.h"
+#include "Timer.h"
+#include "Utilities/ByteConverter.h"
+
+#include <boost/bind.hpp>
+
+INSTANTIATE_SINGLETON_1(PacketCapture);
+
+static void AppendUInt32(std::vector<uint8>& buffer, uint32 value)
+{
+    EndianConvert(value);
+    uint8 const* bytes = reinterpret_cast<uint8 const*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+static uint32 ReadUInt32(uint8 const* data)
+{
+    uint32 value;
+    memcpy(&value, data, sizeof(value));
+    EndianConvert(value);
+    return value;
+}
+
+// staged record: sequence number followed by the PKT record
+static const uint32 STAGED_PREFIX_SIZE = sizeof(uint32);
+
+typedef std::pair<uint32, uint8 const*> StagedRecord;
+
+static bool StagedRecordLess(StagedRecord const& left, StagedRecord const& right)
+{
+    // sequence numbers wrap, records of one batch are never 2^31 apart
+    return int32(left.first - right.first) < 0;
+}
+
+PacketCapture::PacketCapture() : m_active(false), m_sequence(0), m_threadBuffer(&PacketCapture::NoStagingCleanup),
+    m_stopping(false), m_writerThread(NULL), m_file(NULL), m_fileSize(0), m_maxFileSize(0), m_part(0),
+    m_startTime(0), m_startTick(0)
+{
+}
+
+PacketCapture::~PacketCapture()
+{
+    Finish();
+
+    for (StagingBuffers::const_iterator itr = m_buffers.begin(); itr != m_buffers.end(); ++itr)
+        delete *itr;
+}
+
+void PacketCapture::Initialize()
+{
+    Finish();
+
+    std::string fileName = sConfig.GetStringDefault("PacketCapture.File", "");
+    if (fileName.empty())
+        return;
+
+    uint32 sizeMB = sConfig.GetIntDefault("PacketCapture.Size", 64);
+    if (sizeMB < 1)
+        sizeMB = 1;
+    else if (sizeMB > 1024)
+        sizeMB = 1024;
+
+    // every capture gets its own file, like timestamped log files
+    size_t dot_pos = fileName.find_last_of(".");
+    std::string timestamp = "_" + Log::GetTimestampStr();
+    if (dot_pos != fileName.npos)
+        fileName.insert(dot_pos, timestamp);
+    else
+        fileName += timestamp;
+
+    std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+    if (!logsDir.empty() && logsDir.at(logsDir.length() - 1) != '/' && logsDir.at(logsDir.length() - 1) != '\\')
+        logsDir.append("/");
+
+    m_fileName = logsDir + fileName;
+    m_maxFileSize = sizeMB * 1024 * 1024;
+    m_startTime = uint32(time(NULL));
+    m_startTick = WorldTimer::getMSTime();
+    m_part = 1;
+
+    if (!OpenFile())
+        return;
+
+    m_opcodes.clear();
+    std::string opcodes = sConfig.GetStringDefault("PacketCapture.Opcodes", "");
+    Tokens opcodeTokens(opcodes, ',');
+    for (Tokens::const_iterator itr = opcodeTokens.begin(); itr != opcodeTokens.end(); ++itr)
+    {
+        uint32 opcode = strtoul(*itr, NULL, 0);
+        if (opcode >= NUM_MSG_TYPES)
+        {
+            sLog.outError("PacketCapture: opcode %s in PacketCapture.Opcodes does not exist, skipped", *itr);
+            continue;
+        }
+
+        m_opcodes.resize(NUM_MSG_TYPES, false);
+        m_opcodes[opcode] = true;
+    }
+
+    m_addresses.clear();
+    std::string addresses = sConfig.GetStringDefault("PacketCapture.Addresses", "");
+    Tokens addressTokens(addresses, ',');
+    for (Tokens::const_iterator itr = addressTokens.begin(); itr != addressTokens.end(); ++itr)
+    {
+        std::string address = *itr;
+        address.erase(0, address.find_first_not_of(' '));
+        address.erase(address.find_last_not_of(' ') + 1);
+        if (!address.empty())
+            m_addresses.insert(address);
+    }
+
+    m_stopping = false;
+
+    m_writerThread = new boost::thread(boost::bind(&PacketCapture::WriterThread, this));
+    m_active = true;
+
+    sLog.outString("Packet capture started (%u MB per file, %s opcodes, %s addresses), written to %s",
+                   sizeMB, m_opcodes.empty() ? "all" : "filtered", m_addresses.empty() ? "all" : "filtered", m_fileName.c_str());
+}
+
+void PacketCapture::Finish()
+{
+    if (!m_writerThread)
+        return;
+
+    // Capture checks the flag under the lock of its staging buffer, the last collect
+    // of the writer sees every record staged before
+    m_active = false;
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_stopping = true;
+    }
+
+    m_condition.notify_one();
+    m_writerThread->join();
+
+    delete m_writerThread;
+    m_writerThread = NULL;
+
+    CloseFile();
+    sLog.outString("Packet capture written to %s", m_fileName.c_str());
+}
+
+PacketCapture::StagingBuffer* PacketCapture::GetStagingBuffer()
+{
+    StagingBuffer* buffer = m_threadBuffer.get();
+    if (!buffer)
+    {
+        // the buffer outlives its thread, the writer may still collect from it
+        buffer = new StagingBuffer;
+        m_threadBuffer.reset(buffer);
+
+        boost::lock_guard<boost::mutex> guard(m_buffersMutex);
+        m_buffers.push_back(buffer);
+    }
+
+    return buffer;
+}
+
+void PacketCapture::Capture(uint32 connection, std::string const& address, WorldPacket const& packet, bool incoming)
+{
+    uint16 opcode = packet.GetOpcode();
+    uint32 recordSize = STAGED_PREFIX_SIZE + RECORD_HEADER_SIZE + sizeof(uint32) + packet.size();
+
+    StagingBuffer* buffer = GetStagingBuffer();
+    boost::lock_guard<boost::mutex> guard(buffer->mutex);
+
+    if (!m_active)
+        return;
+
+    if (!m_opcodes.empty() && (opcode >= m_opcodes.size() || !m_opcodes[opcode]))
+        return;
+
+    if (!m_addresses.empty() && m_addresses.find(address) == m_addresses.end())
+        return;
+
+    ByteVector& records = buffer->records;
+    if (records.size() + recordSize > STAGING_MAX_SIZE)
+    {
+        ++buffer->dropped;
+        return;
+    }
+
+    AppendUInt32(records, m_sequence++);
+
+    // record of the PKT 3.1 format, the data starts with the opcode
+    AppendUInt32(records, incoming ? 0x47534D43 : 0x47534D53);     // "CMSG" or "SMSG"
+    AppendUInt32(records, connection);
+    AppendUInt32(records, WorldTimer::getMSTime());
+    AppendUInt32(records, 0);                                      // no optional data
+    AppendUInt32(records, sizeof(uint32) + packet.size());
+    AppendUInt32(records, opcode);
+    if (packet.size())
+        records.insert(records.end(), packet.contents(), packet.contents() + packet.size());
+
+    if (records.size() >= STAGING_FLUSH_SIZE && records.size() - recordSize < STAGING_FLUSH_SIZE)
+        m_condition.notify_one();
+}
+
+void PacketCapture::WriterThread()
+{
+    std::vector<ByteVector> batch;
+
+    for (;;)
+    {
+        bool stopping;
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            if (!m_stopping)
+                m_condition.timed_wait(lock, boost::posix_time::milliseconds(uint32(FLUSH_INTERVAL)));
+            stopping = m_stopping;
+        }
+
+        uint32 dropped = 0;
+        {
+            boost::lock_guard<boost::mutex> guard(m_buffersMutex);
+            batch.resize(m_buffers.size());
+            for (size_t i = 0; i < m_buffers.size(); ++i)
+            {
+                StagingBuffer* buffer = m_buffers[i];
+                boost::lock_guard<boost::mutex> bufferGuard(buffer->mutex);
+                batch[i].swap(buffer->records);
+                dropped += buffer->dropped;
+                buffer->dropped = 0;
+            }
+        }
+
+        WriteBatch(batch);
+
+        for (size_t i = 0; i < batch.size(); ++i)
+            batch[i].clear();
+
+        if (dropped)
+            sLog.outError("PacketCapture: writer can't keep up, %u packets dropped", dropped);
+
+        // no packets are staged after m_active is cleared
+        if (stopping)
+            return;
+    }
+}
+
+void PacketCapture::WriteBatch(std::vector<ByteVector> const& batch)
+{
+    // records of one thread are in order already, the threads are merged by sequence number
+    std::vector<StagedRecord> records;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        ByteVector const& buffer = batch[i];
+        for (size_t pos = 0; pos < buffer.size();)
+        {
+            uint8 const* record = &buffer[pos];
+            records.push_back(StagedRecord(ReadUInt32(record), record + STAGED_PREFIX_SIZE));
+            pos += STAGED_PREFIX_SIZE + RECORD_HEADER_SIZE + ReadUInt32(record + STAGED_PREFIX_SIZE + 4 * sizeof(uint32));
+        }
+    }
+
+    if (records.empty() || !m_file)
+        return;
+
+    std::sort(records.begin(), records.end(), StagedRecordLess);
+
+    for (std::vector<StagedRecord>::const_iterator itr = records.begin(); itr != records.end(); ++itr)
+    {
+        uint32 size = RECORD_HEADER_SIZE + ReadUInt32(itr->second + 4 * sizeof(uint32));
+
+        // continue in a new part, every part is a complete capture file
+        if (m_fileSize + size > m_maxFileSize)
+        {
+            CloseFile();
+            if (m_part > 1)
+                std::remove(GetPartFileName(m_part - 1).c_str());
+
+            ++m_part;
+            if (!OpenFile())
+                return;
+        }
+
+        fwrite(itr->second, 1, size, m_file);
+        m_fileSize += size;
+    }
+
+    // the records are readable from the file if the server crashes
+    fflush(m_file);
+}
+
+std::string PacketCapture::GetPartFileName(uint32 part) const
+{
+    if (part <= 1)
+        return m_fileName;
+
+    std::string fileName = m_fileName;
+    size_t dot_pos = fileName.find_last_of(".");
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_part%u", part);
+    if (dot_pos != fileName.npos && fileName.find_first_of("/\\", dot_pos) == fileName.npos)
+        fileName.insert(dot_pos, suffix);
+    else
+        fileName += suffix;
+
+    return fileName;
+}
+
+bool PacketCapture::OpenFile()
+{
+    std::string fileName = GetPartFileName(m_part);
+    m_file = fopen(fileName.c_str(), "wb");
+    if (!m_file)
+    {
+        sLog.outError("PacketCapture: can't create capture file %s", fileName.c_str());
+        return false;
+    }
+
+    static const int clientBuilds[] = EXPECTED_MANGOSD_CLIENT_BUILD;
+
+    // PKT 3.1 header
+    ByteVector header;
+    header.push_back('P');
+    header.push_back('K');
+    header.push_back('T');
+    header.push_back(0x01);                                 // version 3.1
+    header.push_back(0x03);
+    header.push_back(0);                                    // sniffer id
+    AppendUInt32(header, clientBuilds[0]);
+    header.push_back('e');
+    header.push_back('n');
+    header.push_back('U');
+    header.push_back('S');
+    header.resize(header.size() + 40, 0);                   // session key
+    AppendUInt32(header, m_startTime);
+    AppendUInt32(header, m_startTick);
+    AppendUInt32(header, 0);                                // no optional header data
+
+    fwrite(&header[0], 1, header.size(), m_file);
+    fflush(m_file);
+    m_fileSize = header.size();
+    return true;
+}
+
+void PacketCapture::CloseFile()
+{
+    if (!m_file)
+        return;
+
+    fclose(m_file);
+    m_file = NULL;
+    m_fileSize = 0;
+}
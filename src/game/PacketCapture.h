@@ -0,0 +1,122 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKETCAPTURE_H
+#define MANGOS_PACKETCAPTURE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
+
+class WorldPacket;
+
+/**
+ * Binary capture of world packets in the PKT 3.1 sniff format.
+ *
+ * Network and world threads only check the opcode and address filters and append the
+ * packet to a staging buffer of their own. A writer thread collects the buffers in
+ * capture order and appends the records to a .pkt file, which starts with a valid header
+ * and is flushed every interval, so the capture stays readable by common packet parsers
+ * after a crash. A file is continued in a new part when it reaches the size limit, only
+ * the current and the previous part are kept. This two part rotation replaces a memory
+ * mapped ring, which can't keep a wrapped capture a valid PKT file.
+ */
+class PacketCapture : public boost::noncopyable
+{
+    public:
+        PacketCapture();
+        ~PacketCapture();
+
+        /// Start capturing as configured, a running capture is finished first
+        void Initialize();
+        /// Stop capturing and close the capture file
+        void Finish();
+
+        bool IsActive() const { return m_active; }
+
+        /// Queue the packet if it passes the filters, called by network and world threads
+        void Capture(uint32 connection, std::string const& address, WorldPacket const& packet, bool incoming);
+
+    private:
+        enum
+        {
+            RECORD_HEADER_SIZE  = 5 * sizeof(uint32),       // direction, connection, tick, optional data and data length
+            STAGING_FLUSH_SIZE  = 1024 * 1024,              // wake the writer before the flush interval
+            STAGING_MAX_SIZE    = 16 * 1024 * 1024,         // drop packets when the writer can't keep up
+            FLUSH_INTERVAL      = 100                       // ms
+        };
+
+        typedef std::vector<uint8> ByteVector;
+
+        // records staged by one thread, each one prefixed with its capture sequence number
+        struct StagingBuffer
+        {
+            StagingBuffer() : dropped(0) {}
+
+            boost::mutex mutex;                             // only contended by the writer thread
+            ByteVector records;
+            uint32 dropped;
+        };
+
+        typedef std::vector<StagingBuffer*> StagingBuffers;
+
+        StagingBuffer* GetStagingBuffer();
+        static void NoStagingCleanup(StagingBuffer* /*buffer*/) {}
+
+        void WriterThread();
+        void WriteBatch(std::vector<ByteVector> const& batch);
+        bool OpenFile();
+        void CloseFile();
+        std::string GetPartFileName(uint32 part) const;
+
+        boost::atomic<bool> m_active;
+        boost::atomic<uint32> m_sequence;                   // keeps records of all threads in capture order
+
+        boost::thread_specific_ptr<StagingBuffer> m_threadBuffer;
+        StagingBuffers m_buffers;                           // owned, kept for the next capture
+        boost::mutex m_buffersMutex;                        // guards m_buffers
+
+        boost::mutex m_mutex;                               // guards m_stopping
+        boost::condition_variable m_condition;
+        bool m_stopping;
+
+        // filters are only changed while the capture is not active
+        std::vector<bool> m_opcodes;                        // captured opcodes, empty for all
+        std::set<std::string> m_addresses;                  // captured client addresses, empty for all
+
+        boost::thread* m_writerThread;
+
+        // used by the writer thread only while it runs
+        FILE* m_file;
+        uint32 m_fileSize;
+        uint32 m_maxFileSize;
+        uint32 m_part;
+
+        std::string m_fileName;
+        uint32 m_startTime;
+        uint32 m_startTick;
+};
+
+#define sPacketCapture MaNGOS::Singleton<PacketCapture>::Instance()
+
+#endif
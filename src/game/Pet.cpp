@@ -382,8 +382,8 @@ void Pet::SavePetToDB(PetSaveMode mode)
         if (getPetType() == HUNTER_PET && mode != PET_SAVE_AS_CURRENT)
             RemoveAllAuras();
 
-        // save pet's data as one single transaction
-        CharacterDatabase.BeginTransaction();
+        // save pet's data as one single transaction, ordered with the saves of the owner
+        CharacterDatabase.BeginTransaction(GetOwnerGuid().GetCounter());
 
         _SaveSpells();
 
@@ -432,12 +432,9 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(NULL), m_
 
     m_areaUpdateId = 0;
 
+    // replaced by the character's save time at load, see World::GetAutoSaveDelay
     m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
 
-    // randomize first save time in range [CONFIG_UINT32_INTERVAL_SAVE] around [CONFIG_UINT32_INTERVAL_SAVE]
-    // this must help in case next save after mass player load after server startup
-    m_nextSave = urand(m_nextSave / 2, m_nextSave * 3 / 2);
-
     clearResurrectRequestData();
 
     memset(m_items, 0, sizeof(Item*) * PLAYER_SLOTS_COUNT);
@@ -1399,9 +1396,16 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     {
         if (update_diff >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            DETAIL_LOG("%s saved", GetGuidStr().c_str());
+            // postpone while the character database is behind with async requests
+            if (uint32 throttleDelay = sWorld.GetAutoSaveThrottleDelay())
+                m_nextSave = throttleDelay;
+            else
+            {
+                SaveToDB();
+                // back to the character's save time, SaveToDB resets to a full interval
+                m_nextSave = sWorld.GetAutoSaveDelay(GetGUIDLow());
+                DETAIL_LOG("%s saved", GetGuidStr().c_str());
+            }
         }
         else
             m_nextSave -= update_diff;
@@ -1537,7 +1541,10 @@ void Player::SetDeathState(DeathState s)
         GetAchievementMgr().UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_DEATH_IN_DUNGEON, 1);
 
         if (InstanceData* mapInstance = GetInstanceData())
+        {
+            Map::ScriptGuard guard(*GetMap());
             mapInstance->OnPlayerDeath(this);
+        }
     }
 
     Unit::SetDeathState(s);
@@ -3847,10 +3854,17 @@ void Player::_LoadSpellCooldowns(QueryResult *result)
 
         delete result;
     }
+
+    // cooldowns added while loading are already stored
+    SetSpellCooldownsSaved();
 }
 
 void Player::_SaveSpellCooldowns()
 {
+    // outdated cooldowns are skipped at load, rewrite only after cooldowns were added or removed
+    if (!IsSpellCooldownsChanged())
+        return;
+
     static SqlStatementID deleteSpellCooldown;
     CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?")
         .PExecute(GetGUIDLow());
@@ -3861,13 +3875,17 @@ void Player::_SaveSpellCooldowns()
     // remove outdated and save active
     RemoveOutdatedSpellCooldowns();
 
-    static SqlStatementID insertSpellCooldown;
-    SqlStatement stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES(?, ?, ?, ?)");
+    static SqlStatementID insCooldown;
+    static SqlStatementID insCooldowns;
+
+    SqlBatchInsert insertCooldowns(CharacterDatabase, insCooldown, insCooldowns, "INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ", 4);
     for (SpellCooldowns::const_iterator itr = GetSpellCooldownMap()->begin(); itr != GetSpellCooldownMap()->end(); ++itr)
     {
         if (itr->second.end <= infTime)                 // not save locked cooldowns, it will be reset or set at reload
-            stmt.PExecute(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
+            insertCooldowns.AddRow(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
     }
+
+    SetSpellCooldownsSaved();
 }
 
 uint32 Player::resetTalentsCost() const
@@ -4331,7 +4349,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             QueryResult* resultFriend = CharacterDatabase.PQuery("SELECT DISTINCT guid FROM character_social WHERE friend = %u", lowGuid);
 
             // NOW we can finally clear other DB data related to character
-            CharacterDatabase.BeginTransaction();
+            CharacterDatabase.BeginTransaction(lowGuid);
             if (resultPets)
             {
                 do
@@ -7016,7 +7034,10 @@ void Player::UpdateArea(uint32 newArea)
     {
         // call this method in order to handle some scripted maps
         if (InstanceData* mapInstance = GetInstanceData())
+        {
+            Map::ScriptGuard guard(*GetMap());
             mapInstance->OnPlayerEnterArea(this, newArea, m_areaUpdateId);
+        }
     }
 
     m_areaUpdateId = newArea;
@@ -7092,7 +7113,10 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea)
 
         // Called when a player leave zone
         if (InstanceData* mapInstance = GetInstanceData())
+        {
+            Map::ScriptGuard guard(*GetMap());
             mapInstance->OnPlayerLeaveZone(this, m_zoneUpdateId);
+        }
 
         // handle outdoor pvp zones
         sOutdoorPvPMgr.HandlePlayerLeaveZone(this, m_zoneUpdateId);
@@ -7102,7 +7126,10 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea)
 
         // call this method in order to handle some scripted zones
         if (InstanceData* mapInstance = GetInstanceData())
+        {
+            Map::ScriptGuard guard(*GetMap());
             mapInstance->OnPlayerEnterZone(this, newZone, newArea);
+        }
 
         if (sWorld.getConfig(CONFIG_BOOL_WEATHER))
         {
@@ -16321,6 +16348,9 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
 
     _LoadEquipmentSets(holder->GetResult(PLAYER_LOGIN_QUERY_LOADEQUIPMENTSETS));
 
+    // spread autosaves after mass logins, e.g. at server startup
+    m_nextSave = sWorld.GetAutoSaveDelay(GetGUIDLow());
+
     sLFGMgr.CreateLFGState(GetObjectGuid());
     if (!GetGroup() || !GetGroup()->isLFDGroup())
     {
@@ -17690,7 +17720,8 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
-    CharacterDatabase.BeginTransaction();
+    // keep saves of one character in order while other characters are saved by other async connections
+    CharacterDatabase.BeginTransaction(GetGUIDLow());
 
     static SqlStatementID delChar ;
     static SqlStatementID insChar ;
@@ -17956,7 +17987,6 @@ void Player::_SaveActions()
 void Player::_SaveAuras()
 {
     static SqlStatementID deleteAuras ;
-    static SqlStatementID insertAuras ;
 
     SqlStatement stmt0 = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
     stmt0.PExecute(GetGUIDLow());
@@ -17966,9 +17996,11 @@ void Player::_SaveAuras()
     if (auraHolders.empty())
         return;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-        "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    // remaining durations change all the time, so all auras are rewritten but in multi-row inserts
+    static SqlStatementID insAura;
+    static SqlStatementID insAuras;
+    SqlBatchInsert insertAuras(CharacterDatabase, insAura, insAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
+        "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) VALUES ", 15);
 
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
     {
@@ -18003,23 +18035,22 @@ void Player::_SaveAuras()
             if (!effIndexMask)
                 continue;
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(itr->second->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(itr->second->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(itr->second->GetId());
-            stmt.addUInt32(itr->second->GetStackAmount());
-            stmt.addUInt8(itr->second->GetAuraCharges());
+            insertAuras.addUInt32(GetGUIDLow());
+            insertAuras.addUInt64(itr->second->GetCasterGuid().GetRawValue());
+            insertAuras.addUInt32(itr->second->GetCastItemGuid().GetCounter());
+            insertAuras.addUInt32(itr->second->GetId());
+            insertAuras.addUInt32(itr->second->GetStackAmount());
+            insertAuras.addUInt32(itr->second->GetAuraCharges());
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addInt32(damage[i]);
+                insertAuras.addInt32(damage[i]);
 
             for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-                stmt.addUInt32(periodicTime[i]);
+                insertAuras.addUInt32(periodicTime[i]);
 
-            stmt.addInt32(itr->second->GetAuraMaxDuration());
-            stmt.addInt32(itr->second->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
-            stmt.Execute();
+            insertAuras.addInt32(itr->second->GetAuraMaxDuration());
+            insertAuras.addInt32(itr->second->GetAuraDuration());
+            insertAuras.addUInt32(effIndexMask);
         }
     }
 }
@@ -18314,12 +18345,13 @@ void Player::_SaveDailyQuestStatus()
     CharacterDatabase.CreateStatement(delQuestStatus, "DELETE FROM character_queststatus_daily WHERE guid = ?")
         .PExecute(GetGUIDLow());
 
-    static SqlStatementID insQuestStatus;
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insQuestStatus, "INSERT INTO character_queststatus_daily (guid,quest) VALUES (?, ?)");
+    static SqlStatementID insQuest;
+    static SqlStatementID insQuests;
+    SqlBatchInsert insQuestStatus(CharacterDatabase, insQuest, insQuests, "INSERT INTO character_queststatus_daily (guid,quest) VALUES ", 2);
 
     for (uint32 quest_daily_idx = 0; quest_daily_idx < PLAYER_MAX_DAILY_QUESTS; ++quest_daily_idx)
         if (GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx))
-            stmtIns.PExecute(GetGUIDLow(), GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx));
+            insQuestStatus.AddRow(GetGUIDLow(), GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1+quest_daily_idx));
 
     m_DailyQuestChanged = false;
 }
@@ -18334,13 +18366,14 @@ void Player::_SaveWeeklyQuestStatus()
     CharacterDatabase.CreateStatement(delQuestStatus, "DELETE FROM character_queststatus_weekly WHERE guid = ?")
         .PExecute(GetGUIDLow());
 
-    static SqlStatementID insQuestStatus;
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insQuestStatus, "INSERT INTO character_queststatus_weekly (guid, quest) VALUES (?, ?)");
+    static SqlStatementID insQuest;
+    static SqlStatementID insQuests;
+    SqlBatchInsert insQuestStatus(CharacterDatabase, insQuest, insQuests, "INSERT INTO character_queststatus_weekly (guid, quest) VALUES ", 2);
 
     for (QuestSet::const_iterator iter = m_weeklyquests.begin(); iter != m_weeklyquests.end(); ++iter)
     {
         uint32 quest_id = *iter;
-        stmtIns.PExecute(GetGUIDLow(), quest_id);
+        insQuestStatus.AddRow(GetGUIDLow(), quest_id);
     }
 
     m_WeeklyQuestChanged = false;
@@ -18356,13 +18389,14 @@ void Player::_SaveMonthlyQuestStatus()
     CharacterDatabase.CreateStatement(deleteQuest, "DELETE FROM character_queststatus_monthly WHERE guid = ?")
         .PExecute(GetGUIDLow());
 
-    static SqlStatementID insertQuest;
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insertQuest, "INSERT INTO character_queststatus_monthly (guid, quest) VALUES (?, ?)");
+    static SqlStatementID insQuest;
+    static SqlStatementID insQuests;
+    SqlBatchInsert insertQuest(CharacterDatabase, insQuest, insQuests, "INSERT INTO character_queststatus_monthly (guid, quest) VALUES ", 2);
 
     for (QuestSet::const_iterator iter = m_monthlyquests.begin(); iter != m_monthlyquests.end(); ++iter)
     {
         uint32 quest_id = *iter;
-        stmtIns.PExecute(GetGUIDLow(), quest_id);
+        insertQuest.AddRow(GetGUIDLow(), quest_id);
     }
 
     m_MonthlyQuestChanged = false;
@@ -18423,10 +18457,11 @@ void Player::_SaveSkills()
 void Player::_SaveSpells()
 {
     static SqlStatementID delSpells;
+    static SqlStatementID insSpell;
     static SqlStatementID insSpells;
 
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delSpells, "DELETE FROM character_spell WHERE guid = ? and spell = ?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insSpells, "INSERT INTO character_spell (guid,spell,active,disabled) VALUES (?, ?, ?, ?)");
+    SqlBatchInsert insertSpells(CharacterDatabase, insSpell, insSpells, "INSERT INTO character_spell (guid,spell,active,disabled) VALUES ", 4);
 
     for (PlayerSpellMap::iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end();)
     {
@@ -18439,7 +18474,7 @@ void Player::_SaveSpells()
 
             // add only changed/new not dependent spells
             if (!itr->second.dependent && (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED))
-                stmtIns.PExecute(GetGUIDLow(), itr->first, uint8(itr->second.active ? 1 : 0), uint8(itr->second.disabled ? 1 : 0));
+                insertSpells.AddRow(GetGUIDLow(), itr->first, uint8(itr->second.active ? 1 : 0), uint8(itr->second.disabled ? 1 : 0));
         }
 
         if (itr->second.state == PLAYERSPELL_REMOVED)
@@ -18455,10 +18490,11 @@ void Player::_SaveSpells()
 void Player::_SaveTalents()
 {
     static SqlStatementID delTalents;
+    static SqlStatementID insTalent;
     static SqlStatementID insTalents;
 
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delTalents, "DELETE FROM character_talent WHERE guid = ? and talent_id = ? and spec = ?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insTalents, "INSERT INTO character_talent (guid, talent_id, current_rank , spec) VALUES (?, ?, ?, ?)");
+    SqlBatchInsert insertTalents(CharacterDatabase, insTalent, insTalents, "INSERT INTO character_talent (guid, talent_id, current_rank , spec) VALUES ", 4);
 
     for (uint32 i = 0; i < MAX_TALENT_SPEC_COUNT; ++i)
     {
@@ -18469,7 +18505,7 @@ void Player::_SaveTalents()
 
             // add only changed/new talents
             if (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED)
-                stmtIns.PExecute(GetGUIDLow(), itr->first, itr->second.currentRank, i);
+                insertTalents.AddRow(GetGUIDLow(), itr->first, itr->second.currentRank, i);
 
             if (itr->second.state == PLAYERSPELL_REMOVED)
                 m_talents[i].erase(itr++);
@@ -22031,6 +22067,7 @@ void Player::UpdateUnderwaterState(Map* m, float x, float y, float z)
                         {
                             if (InstanceData* pInst = GetInstanceData())
                             {
+                                Map::ScriptGuard guard(*GetMap());
                                 if (pInst->CheckConditionCriteriaMeet(this, INSTANCE_CONDITION_ID_LURKER, NULL, CONDITION_FROM_HARDCODED))
                                 {
                                     if (pInst->CheckConditionCriteriaMeet(this, INSTANCE_CONDITION_ID_SCALDING_WATER, NULL, CONDITION_FROM_HARDCODED))
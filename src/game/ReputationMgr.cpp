@@ -523,19 +523,16 @@ void ReputationMgr::LoadFromDB(QueryResult* result)
 
 void ReputationMgr::SaveToDB()
 {
-    static SqlStatementID delRep ;
-    static SqlStatementID insRep ;
-
-    SqlStatement stmtDel = CharacterDatabase.CreateStatement(delRep, "DELETE FROM character_reputation WHERE guid = ? AND faction=?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insRep, "INSERT INTO character_reputation (guid,faction,standing,flags) VALUES (?, ?, ?, ?)");
+    static SqlStatementID replaceRepRow;
+    static SqlStatementID replaceRepRows;
+    SqlBatchInsert replaceRep(CharacterDatabase, replaceRepRow, replaceRepRows, "REPLACE INTO character_reputation (guid,faction,standing,flags) VALUES ", 4);
 
     for (FactionStateList::iterator itr = m_factions.begin(); itr != m_factions.end(); ++itr)
     {
         FactionState &faction = itr->second;
         if (faction.needSave)
         {
-            stmtDel.PExecute(m_player->GetGUIDLow(), faction.ID);
-            stmtIns.PExecute(m_player->GetGUIDLow(), faction.ID, faction.Standing, faction.Flags);
+            replaceRep.AddRow(m_player->GetGUIDLow(), uint32(faction.ID), faction.Standing, uint32(faction.Flags));
             faction.needSave = false;
         }
     }
@@ -26,6 +26,7 @@
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "Cell.h"
+#include "Map.h"
 #include "CellImpl.h"
 #include "SQLStorages.h"
 #include "BattleGround/BattleGround.h"
@@ -2253,27 +2254,48 @@ bool ScriptMgr::OnProcessEvent(uint32 eventId, Object* pSource, Object* pTarget,
 
 bool ScriptMgr::OnEffectDummy(Unit* pCaster, uint32 spellId, SpellEffectIndex effIndex, Creature* pTarget, ObjectGuid originalCasterGuid)
 {
-    return m_pOnEffectDummyCreature != NULL && m_pOnEffectDummyCreature(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
+    if (!m_pOnEffectDummyCreature)
+        return false;
+
+    // spells are processed in parallel grid region updates, see Map::ScriptGuard
+    Map::ScriptGuard guard(*pTarget->GetMap());
+    return m_pOnEffectDummyCreature(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
 }
 
 bool ScriptMgr::OnEffectDummy(Unit* pCaster, uint32 spellId, SpellEffectIndex effIndex, GameObject* pTarget, ObjectGuid originalCasterGuid)
 {
-    return m_pOnEffectDummyGO != NULL && m_pOnEffectDummyGO(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
+    if (!m_pOnEffectDummyGO)
+        return false;
+
+    Map::ScriptGuard guard(*pTarget->GetMap());
+    return m_pOnEffectDummyGO(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
 }
 
 bool ScriptMgr::OnEffectDummy(Unit* pCaster, uint32 spellId, SpellEffectIndex effIndex, Item* pTarget, ObjectGuid originalCasterGuid)
 {
-    return m_pOnEffectDummyItem != NULL && m_pOnEffectDummyItem(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
+    if (!m_pOnEffectDummyItem)
+        return false;
+
+    Map::ScriptGuard guard(*pCaster->GetMap());
+    return m_pOnEffectDummyItem(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
 }
 
 bool ScriptMgr::OnEffectScriptEffect(Unit* pCaster, uint32 spellId, SpellEffectIndex effIndex, Creature* pTarget, ObjectGuid originalCasterGuid)
 {
-    return m_pOnEffectScriptEffectCreature != NULL && m_pOnEffectScriptEffectCreature(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
+    if (!m_pOnEffectScriptEffectCreature)
+        return false;
+
+    Map::ScriptGuard guard(*pTarget->GetMap());
+    return m_pOnEffectScriptEffectCreature(pCaster, spellId, effIndex, pTarget, originalCasterGuid);
 }
 
 bool ScriptMgr::OnAuraDummy(Aura const* pAura, bool apply)
 {
-    return m_pOnAuraDummy != NULL && m_pOnAuraDummy(pAura, apply);
+    if (!m_pOnAuraDummy)
+        return false;
+
+    Map::ScriptGuard guard(*pAura->GetTarget()->GetMap());
+    return m_pOnAuraDummy(pAura, apply);
 }
 
 ScriptLoadResult ScriptMgr::LoadScriptLibrary(const char* libName)
@@ -6123,7 +6123,10 @@ void Aura::HandleAuraModEffectImmunity(bool apply, bool /*Real*/)
         else if (OutdoorPvP* outdoorPvP = sOutdoorPvPMgr.GetScript(player->GetCachedZoneId()))
             outdoorPvP->HandleDropFlag(player, GetSpellProto()->Id);
         else if (InstanceData* mapInstance = player->GetInstanceData())
+        {
+            Map::ScriptGuard guard(*player->GetMap());
             mapInstance->OnPlayerDroppedFlag(player, GetId());
+        }
     }
 
     target->ApplySpellImmune(GetId(), IMMUNITY_EFFECT, m_modifier.m_miscvalue, apply);
@@ -10043,6 +10046,7 @@ void Aura::PeriodicDummyTick()
 
                     if (InstanceData* data = target->GetInstanceData())
                     {
+                        Map::ScriptGuard guard(*target->GetMap());
                         if (Creature* pSpike = target->GetMap()->GetCreature(data->GetGuid(34660)))
                             pSpike->AddThreat(target, 1000000.0f);
                     }
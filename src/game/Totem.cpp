@@ -62,7 +62,10 @@ bool Totem::Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo const*
     //Only works if you create the object in it, not if it is moves to that map.
     //Normally non-players do not teleport to other maps.
     if (InstanceData* iData = GetMap()->GetInstanceData())
+    {
+        Map::ScriptGuard guard(*GetMap());
         iData->OnCreatureCreate(this);
+    }
 
     LoadCreatureAddon(false);
 
@@ -217,6 +217,8 @@ Unit::Unit() :
 
     m_extraAttacks = 0;
 
+    m_spellCooldownsChanged = false;
+
     m_state = 0;
     m_deathState = ALIVE;
 
@@ -1288,7 +1290,10 @@ void Unit::JustKilledCreature(Creature* victim, Player* responsiblePlayer)
 
     // Inform Instance Data and Linking
     if (InstanceData* mapInstance = victim->GetInstanceData())
+    {
+        Map::ScriptGuard guard(*victim->GetMap());
         mapInstance->OnCreatureDeath(victim);
+    }
 
     // Notify the outdoor pvp script
     if (OutdoorPvP* outdoorPvP = sOutdoorPvPMgr.GetScript(GetZoneId()))
@@ -9946,7 +9951,10 @@ void Unit::SetInCombatState(bool PvP, Unit* enemy)
             pCreature->SetInCombatWithZone();
 
         if (InstanceData* mapInstance = GetInstanceData())
+        {
+            Map::ScriptGuard guard(*GetMap());
             mapInstance->OnCreatureEnterCombat(pCreature);
+        }
 
         if (m_isCreatureLinkingTrigger)
             GetMap()->GetCreatureLinkingHolder()->DoCreatureLinkingEvent(LINKING_EVENT_AGGRO, pCreature, enemy);
@@ -14746,11 +14754,13 @@ void Unit::AddSpellCooldown(uint32 spellid, uint32 itemid, time_t end_time)
     sc.end = end_time;
     sc.itemid = itemid;
     m_spellCooldowns[spellid] = sc;
+    m_spellCooldownsChanged = true;
 }
 
 void Unit::RemoveSpellCooldown(uint32 spell_id, bool update /* = false */)
 {
-    m_spellCooldowns.erase(spell_id);
+    if (m_spellCooldowns.erase(spell_id))
+        m_spellCooldownsChanged = true;
 
     if (update && GetTypeId() == TYPEID_PLAYER)
         ((Player*)this)->SendClearCooldown(spell_id, this);
@@ -14772,6 +14782,7 @@ void Unit::RemoveAllSpellCooldown()
         }
 
         m_spellCooldowns.clear();
+        m_spellCooldownsChanged = true;
     }
 }
 
@@ -14956,18 +14967,14 @@ time_t Unit::GetSpellCooldownDelay(SpellEntry const* spellInfo) const
 
 void Unit::RemoveOutdatedSpellCooldowns()
 {
-    // remove oudated
+    // remove oudated, they are skipped at load so saved cooldowns need no update
     time_t curTime = time(NULL);
-    SpellCooldowns const* cm = GetSpellCooldownMap();
-    SpellCooldowns::const_iterator itr, next;
-    for( itr = cm->begin();itr != cm->end(); itr = next)
+    for (SpellCooldowns::iterator itr = m_spellCooldowns.begin(); itr != m_spellCooldowns.end();)
     {
-        next = itr;
-        ++next;
         if (itr->second.end <= curTime)
-        {
-            RemoveSpellCooldown(itr->first);
-        }
+            m_spellCooldowns.erase(itr++);
+        else
+            ++itr;
     }
 }
 
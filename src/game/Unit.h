@@ -2286,6 +2286,8 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         bool HasSpellCooldown(uint32 spellId) const;
         time_t GetSpellCooldownDelay(SpellEntry const* spellInfo) const;
         SpellCooldowns const* GetSpellCooldownMap() const { return &m_spellCooldowns; }
+        bool IsSpellCooldownsChanged() const { return m_spellCooldownsChanged; }
+        void SetSpellCooldownsSaved() { m_spellCooldownsChanged = false; }
 
         void RemoveOutdatedSpellCooldowns();
 
@@ -2404,6 +2406,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         ObjectGuid m_fixateTargetGuid;                      //< Stores the Guid of a fixated target
 
         SpellCooldowns m_spellCooldowns;
+        bool m_spellCooldownsChanged;                       // cooldowns added or removed since last save
 
     private:                                                // Error traps for some wrong args using
         // this will catch and prevent build for any cases when all optional args skipped and instead triggered used non boolean type
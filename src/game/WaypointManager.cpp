@@ -92,143 +92,143 @@ void WaypointManager::Load()
 
         delete result;
 
-        //                                   0   1      2           3           4           5         6
-        result = WorldDatabase.Query("SELECT id, point, position_x, position_y, position_z, waittime, script_id,"
-                                     //   7        8        9        10       11       12     13     14           15      16
-                                     "textid1, textid2, textid3, textid4, textid5, emote, spell, orientation, model1, model2 FROM creature_movement");
+        //                                           0   1      2           3           4           5         6
+        result = WorldDatabase.QueryStreamed("SELECT id, point, position_x, position_y, position_z, waittime, script_id,"
+                                             //   7        8        9        10       11       12     13     14           15      16
+                                             "textid1, textid2, textid3, textid4, textid5, emote, spell, orientation, model1, model2 FROM creature_movement");
 
-        BarGoLink barRow((int)result->GetRowCount());
-
-        // error after load, we check if creature guid corresponding to the path id has proper MovementType
-        std::set<uint32> creatureNoMoveType;
-
-        do
+        if (!result)
         {
-            barRow.step();
-            Field* fields = result->Fetch();
-            uint32 id           = fields[0].GetUInt32();
-            uint32 point        = fields[1].GetUInt32();
+            sLog.outString();
+            sLog.outErrorDb(">> Failed to load waypoints from `creature_movement`.");
+        }
+        else
+        {
+            BarGoLink barRow(total_nodes);
 
-            const CreatureData* cData = sObjectMgr.GetCreatureData(id);
+            // error after load, we check if creature guid corresponding to the path id has proper MovementType
+            std::set<uint32> creatureNoMoveType;
 
-            if (!cData)
+            do
             {
-                sLog.outErrorDb("Table creature_movement contain path for creature guid %u, but this creature guid does not exist. Skipping.", id);
-                continue;
-            }
+                barRow.step();
+                Field* fields = result->Fetch();
+                uint32 id           = fields[0].GetUInt32();
+                uint32 point        = fields[1].GetUInt32();
 
-            if (cData->movementType != WAYPOINT_MOTION_TYPE)
-                creatureNoMoveType.insert(id);
+                const CreatureData* cData = sObjectMgr.GetCreatureData(id);
 
-            WaypointPath& path  = m_pathMap[id];
-            WaypointNode& node  = path[point];
+                if (!cData)
+                {
+                    sLog.outErrorDb("Table creature_movement contain path for creature guid %u, but this creature guid does not exist. Skipping.", id);
+                    continue;
+                }
 
-            node.x              = fields[2].GetFloat();
-            node.y              = fields[3].GetFloat();
-            node.z              = fields[4].GetFloat();
-            node.orientation    = fields[14].GetFloat();
-            node.delay          = fields[5].GetUInt32();
-            node.script_id      = fields[6].GetUInt32();
+                if (cData->movementType != WAYPOINT_MOTION_TYPE)
+                    creatureNoMoveType.insert(id);
 
-            // prevent using invalid coordinates
-            if (!MaNGOS::IsValidMapCoord(node.x, node.y, node.z, node.orientation))
-            {
-                QueryResult* result1 = WorldDatabase.PQuery("SELECT id, map FROM creature WHERE guid = '%u'", id);
-                if (result1)
-                    sLog.outErrorDb("Creature (guidlow %d, entry %d) have invalid coordinates in his waypoint %d (X: %f, Y: %f).",
-                                    id, result1->Fetch()[0].GetUInt32(), point, node.x, node.y);
-                else
-                    sLog.outErrorDb("Waypoint path %d, have invalid coordinates in his waypoint %d (X: %f, Y: %f).",
-                                    id, point, node.x, node.y);
+                WaypointPath& path  = m_pathMap[id];
+                WaypointNode& node  = path[point];
 
-                MaNGOS::NormalizeMapCoord(node.x);
-                MaNGOS::NormalizeMapCoord(node.y);
+                node.x              = fields[2].GetFloat();
+                node.y              = fields[3].GetFloat();
+                node.z              = fields[4].GetFloat();
+                node.orientation    = fields[14].GetFloat();
+                node.delay          = fields[5].GetUInt32();
+                node.script_id      = fields[6].GetUInt32();
 
-                if (result1)
+                // prevent using invalid coordinates
+                if (!MaNGOS::IsValidMapCoord(node.x, node.y, node.z, node.orientation))
                 {
-                    node.z = sTerrainMgr.LoadTerrain(result1->Fetch()[1].GetUInt32())->GetHeightStatic(node.x, node.y, node.z);
-                    delete result1;
-                }
+                    // creature data is already loaded, no query while the path rows are streamed
+                    sLog.outErrorDb("Creature (guidlow %d, entry %d) have invalid coordinates in his waypoint %d (X: %f, Y: %f).",
+                                    id, cData->id, point, node.x, node.y);
 
-                WorldDatabase.PExecute("UPDATE creature_movement SET position_x = '%f', position_y = '%f', position_z = '%f' WHERE id = '%u' AND point = '%u'", node.x, node.y, node.z, id, point);
-            }
+                    MaNGOS::NormalizeMapCoord(node.x);
+                    MaNGOS::NormalizeMapCoord(node.y);
 
-            if (node.script_id)
-            {
-                if (sCreatureMovementScripts.second.find(node.script_id) == sCreatureMovementScripts.second.end())
-                {
-                    sLog.outErrorDb("Table creature_movement for id %u, point %u have script_id %u that does not exist in `dbscripts_on_creature_movement`, ignoring", id, point, node.script_id);
-                    continue;
+                    node.z = sTerrainMgr.LoadTerrain(cData->mapid)->GetHeightStatic(node.x, node.y, node.z);
+
+                    WorldDatabase.PExecute("UPDATE creature_movement SET position_x = '%f', position_y = '%f', position_z = '%f' WHERE id = '%u' AND point = '%u'", node.x, node.y, node.z, id, point);
                 }
 
-                movementScriptSet.erase(node.script_id);
-            }
+                if (node.script_id)
+                {
+                    if (sCreatureMovementScripts.second.find(node.script_id) == sCreatureMovementScripts.second.end())
+                    {
+                        sLog.outErrorDb("Table creature_movement for id %u, point %u have script_id %u that does not exist in `dbscripts_on_creature_movement`, ignoring", id, point, node.script_id);
+                        continue;
+                    }
 
-            // WaypointBehavior can be dropped in time. Script_id added may 2010 and can handle all the below behavior.
+                    movementScriptSet.erase(node.script_id);
+                }
 
-            WaypointBehavior be;
-            be.model1           = fields[15].GetUInt32();
-            be.model2           = fields[16].GetUInt32();
-            be.emote            = fields[12].GetUInt32();
-            be.spell            = fields[13].GetUInt32();
+                // WaypointBehavior can be dropped in time. Script_id added may 2010 and can handle all the below behavior.
 
-            for (int i = 0; i < MAX_WAYPOINT_TEXT; ++i)
-            {
-                be.textid[i]    = fields[7 + i].GetInt32();
+                WaypointBehavior be;
+                be.model1           = fields[15].GetUInt32();
+                be.model2           = fields[16].GetUInt32();
+                be.emote            = fields[12].GetUInt32();
+                be.spell            = fields[13].GetUInt32();
 
-                if (be.textid[i])
+                for (int i = 0; i < MAX_WAYPOINT_TEXT; ++i)
                 {
-                    if (be.textid[i] < MIN_DB_SCRIPT_STRING_ID || be.textid[i] >= MAX_DB_SCRIPT_STRING_ID)
+                    be.textid[i]    = fields[7 + i].GetInt32();
+
+                    if (be.textid[i])
                     {
-                        sLog.outErrorDb("Table `creature_movement` Id %u, point %u has textid%u has value %d out of range. Must be in %u-%u", id, point, i + 1, be.textid[i], MIN_DB_SCRIPT_STRING_ID, MAX_DB_SCRIPT_STRING_ID - 1);
-                        be.textid[i] = 0;
+                        if (be.textid[i] < MIN_DB_SCRIPT_STRING_ID || be.textid[i] >= MAX_DB_SCRIPT_STRING_ID)
+                        {
+                            sLog.outErrorDb("Table `creature_movement` Id %u, point %u has textid%u has value %d out of range. Must be in %u-%u", id, point, i + 1, be.textid[i], MIN_DB_SCRIPT_STRING_ID, MAX_DB_SCRIPT_STRING_ID - 1);
+                            be.textid[i] = 0;
+                        }
                     }
                 }
-            }
 
-            if (be.spell && ! sSpellStore.LookupEntry(be.spell))
-            {
-                sLog.outErrorDb("Table creature_movement references unknown spellid %u. Skipping id %u with point %u.", be.spell, id, point);
-                be.spell = 0;
-            }
+                if (be.spell && ! sSpellStore.LookupEntry(be.spell))
+                {
+                    sLog.outErrorDb("Table creature_movement references unknown spellid %u. Skipping id %u with point %u.", be.spell, id, point);
+                    be.spell = 0;
+                }
 
-            if (be.emote)
-            {
-                if (!sEmotesStore.LookupEntry(be.emote))
-                    sLog.outErrorDb("Waypoint path %u (Point %u) are using emote %u, but emote does not exist.", id, point, be.emote);
-            }
+                if (be.emote)
+                {
+                    if (!sEmotesStore.LookupEntry(be.emote))
+                        sLog.outErrorDb("Waypoint path %u (Point %u) are using emote %u, but emote does not exist.", id, point, be.emote);
+                }
 
-            // save memory by not storing empty behaviors
-            if (!be.isEmpty())
-            {
-                node.behavior = new WaypointBehavior(be);
-                ++total_behaviors;
+                // save memory by not storing empty behaviors
+                if (!be.isEmpty())
+                {
+                    node.behavior = new WaypointBehavior(be);
+                    ++total_behaviors;
+                }
+                else
+                    node.behavior = NULL;
             }
-            else
-                node.behavior = NULL;
-        }
-        while (result->NextRow());
+            while (result->NextRow());
 
-        if (!creatureNoMoveType.empty())
-        {
-            for (std::set<uint32>::const_iterator itr = creatureNoMoveType.begin(); itr != creatureNoMoveType.end(); ++itr)
+            if (!creatureNoMoveType.empty())
             {
-                const CreatureData* cData = sObjectMgr.GetCreatureData(*itr);
-                const CreatureInfo* cInfo = ObjectMgr::GetCreatureTemplate(cData->id);
+                for (std::set<uint32>::const_iterator itr = creatureNoMoveType.begin(); itr != creatureNoMoveType.end(); ++itr)
+                {
+                    const CreatureData* cData = sObjectMgr.GetCreatureData(*itr);
+                    const CreatureInfo* cInfo = ObjectMgr::GetCreatureTemplate(cData->id);
 
-                sLog.outErrorDb("Table creature_movement has waypoint for creature guid %u (entry %u), but MovementType is not WAYPOINT_MOTION_TYPE(2). Creature will not use this path.", *itr, cData->id);
+                    sLog.outErrorDb("Table creature_movement has waypoint for creature guid %u (entry %u), but MovementType is not WAYPOINT_MOTION_TYPE(2). Creature will not use this path.", *itr, cData->id);
 
-                if (cInfo->MovementType == WAYPOINT_MOTION_TYPE)
-                    sLog.outErrorDb("    creature_template for this entry has MovementType WAYPOINT_MOTION_TYPE(2), did you intend to use creature_movement_template ?");
+                    if (cInfo->MovementType == WAYPOINT_MOTION_TYPE)
+                        sLog.outErrorDb("    creature_template for this entry has MovementType WAYPOINT_MOTION_TYPE(2), did you intend to use creature_movement_template ?");
+                }
             }
-        }
 
-        sLog.outString();
-        sLog.outString(">> Waypoints and behaviors loaded");
-        sLog.outString();
-        sLog.outString(">>> Loaded %u paths, %u nodes and %u behaviors", total_paths, total_nodes, total_behaviors);
+            sLog.outString();
+            sLog.outString(">> Waypoints and behaviors loaded");
+            sLog.outString();
+            sLog.outString(">>> Loaded %u paths, %u nodes and %u behaviors", total_paths, total_nodes, total_behaviors);
 
-        delete result;
+            delete result;
+        }
     }
 
     // creature_movement_template
@@ -265,114 +265,122 @@ void WaypointManager::Load()
         sLog.outString();
         sLog.outString(">> Path templates loaded");
 
-        //                                   0      1      2           3           4           5         6
-        result = WorldDatabase.Query("SELECT entry, point, position_x, position_y, position_z, waittime, script_id,"
-                                     //   7        8        9        10       11       12     13     14           15      16
-                                     "textid1, textid2, textid3, textid4, textid5, emote, spell, orientation, model1, model2 FROM creature_movement_template");
+        //                                           0      1      2           3           4           5         6
+        result = WorldDatabase.QueryStreamed("SELECT entry, point, position_x, position_y, position_z, waittime, script_id,"
+                                             //   7        8        9        10       11       12     13     14           15      16
+                                             "textid1, textid2, textid3, textid4, textid5, emote, spell, orientation, model1, model2 FROM creature_movement_template");
 
-        BarGoLink bar(result->GetRowCount());
-
-        do
+        if (!result)
         {
-            bar.step();
-            Field* fields = result->Fetch();
+            sLog.outString();
+            sLog.outErrorDb(">> Failed to load path templates from `creature_movement_template`.");
+        }
+        else
+        {
+            BarGoLink bar(total_nodes);
 
-            uint32 entry        = fields[0].GetUInt32();
-            uint32 point        = fields[1].GetUInt32();
+            do
+            {
+                bar.step();
+                Field* fields = result->Fetch();
 
-            const CreatureInfo* cInfo = ObjectMgr::GetCreatureTemplate(entry);
+                uint32 entry        = fields[0].GetUInt32();
+                uint32 point        = fields[1].GetUInt32();
 
-            if (!cInfo)
-            {
-                sLog.outErrorDb("Table creature_movement_template references unknown creature template %u. Skipping.", entry);
-                continue;
-            }
+                const CreatureInfo* cInfo = ObjectMgr::GetCreatureTemplate(entry);
 
-            WaypointPath& path = m_pathTemplateMap[entry << 8];
-            WaypointNode& node  = path[point];
+                if (!cInfo)
+                {
+                    sLog.outErrorDb("Table creature_movement_template references unknown creature template %u. Skipping.", entry);
+                    continue;
+                }
 
-            node.x              = fields[2].GetFloat();
-            node.y              = fields[3].GetFloat();
-            node.z              = fields[4].GetFloat();
-            node.orientation    = fields[14].GetFloat();
-            node.delay          = fields[5].GetUInt32();
-            node.script_id      = fields[6].GetUInt32();
+                WaypointPath& path = m_pathTemplateMap[entry << 8];
+                WaypointNode& node  = path[point];
 
-            // prevent using invalid coordinates
-            if (!MaNGOS::IsValidMapCoord(node.x, node.y, node.z, node.orientation))
-            {
-                sLog.outErrorDb("Table creature_movement_template for entry %u (point %u) are using invalid coordinates position_x: %f, position_y: %f)",
-                                entry, point, node.x, node.y);
+                node.x              = fields[2].GetFloat();
+                node.y              = fields[3].GetFloat();
+                node.z              = fields[4].GetFloat();
+                node.orientation    = fields[14].GetFloat();
+                node.delay          = fields[5].GetUInt32();
+                node.script_id      = fields[6].GetUInt32();
 
-                MaNGOS::NormalizeMapCoord(node.x);
-                MaNGOS::NormalizeMapCoord(node.y);
+                // prevent using invalid coordinates
+                if (!MaNGOS::IsValidMapCoord(node.x, node.y, node.z, node.orientation))
+                {
+                    sLog.outErrorDb("Table creature_movement_template for entry %u (point %u) are using invalid coordinates position_x: %f, position_y: %f)",
+                                    entry, point, node.x, node.y);
 
-                sLog.outErrorDb("Table creature_movement_template for entry %u (point %u) are auto corrected to normalized position_x=%f, position_y=%f",
-                                entry, point, node.x, node.y);
+                    MaNGOS::NormalizeMapCoord(node.x);
+                    MaNGOS::NormalizeMapCoord(node.y);
 
-                WorldDatabase.PExecute("UPDATE creature_movement_template SET position_x = '%f', position_y = '%f' WHERE entry = %u AND point = %u", node.x, node.y, entry, point);
-            }
+                    sLog.outErrorDb("Table creature_movement_template for entry %u (point %u) are auto corrected to normalized position_x=%f, position_y=%f",
+                                    entry, point, node.x, node.y);
 
-            if (node.script_id)
-            {
-                if (sCreatureMovementScripts.second.find(node.script_id) == sCreatureMovementScripts.second.end())
-                {
-                    sLog.outErrorDb("Table creature_movement_template for entry %u, point %u have script_id %u that does not exist in `dbscripts_on_creature_movement`, ignoring", entry, point, node.script_id);
-                    continue;
+                    WorldDatabase.PExecute("UPDATE creature_movement_template SET position_x = '%f', position_y = '%f' WHERE entry = %u AND point = %u", node.x, node.y, entry, point);
                 }
 
-                movementScriptSet.erase(node.script_id);
-            }
+                if (node.script_id)
+                {
+                    if (sCreatureMovementScripts.second.find(node.script_id) == sCreatureMovementScripts.second.end())
+                    {
+                        sLog.outErrorDb("Table creature_movement_template for entry %u, point %u have script_id %u that does not exist in `dbscripts_on_creature_movement`, ignoring", entry, point, node.script_id);
+                        continue;
+                    }
 
-            WaypointBehavior be;
-            be.model1           = fields[15].GetUInt32();
-            be.model2           = fields[16].GetUInt32();
-            be.emote            = fields[12].GetUInt32();
-            be.spell            = fields[13].GetUInt32();
+                    movementScriptSet.erase(node.script_id);
+                }
 
-            for (int i = 0; i < MAX_WAYPOINT_TEXT; ++i)
-            {
-                be.textid[i]    = fields[7 + i].GetUInt32();
+                WaypointBehavior be;
+                be.model1           = fields[15].GetUInt32();
+                be.model2           = fields[16].GetUInt32();
+                be.emote            = fields[12].GetUInt32();
+                be.spell            = fields[13].GetUInt32();
 
-                if (be.textid[i])
+                for (int i = 0; i < MAX_WAYPOINT_TEXT; ++i)
                 {
-                    if (be.textid[i] < MIN_DB_SCRIPT_STRING_ID || be.textid[i] >= MAX_DB_SCRIPT_STRING_ID)
+                    be.textid[i]    = fields[7 + i].GetUInt32();
+
+                    if (be.textid[i])
                     {
-                        sLog.outErrorDb("Table `creature_movement_template` Entry %u, point %u has textid%u has value %d out of range. Must be in %u-%u", entry, point, i + 1, be.textid[i], MIN_DB_SCRIPT_STRING_ID, MAX_DB_SCRIPT_STRING_ID - 1);
-                        be.textid[i] = 0;
+                        if (be.textid[i] < MIN_DB_SCRIPT_STRING_ID || be.textid[i] >= MAX_DB_SCRIPT_STRING_ID)
+                        {
+                            sLog.outErrorDb("Table `creature_movement_template` Entry %u, point %u has textid%u has value %d out of range. Must be in %u-%u", entry, point, i + 1, be.textid[i], MIN_DB_SCRIPT_STRING_ID, MAX_DB_SCRIPT_STRING_ID - 1);
+                            be.textid[i] = 0;
+                        }
                     }
                 }
-            }
 
-            if (be.spell && ! sSpellStore.LookupEntry(be.spell))
-            {
-                sLog.outErrorDb("Table creature_movement_template references unknown spellid %u. Skipping id %u with point %u.", be.spell, entry, point);
-                be.spell = 0;
-            }
+                if (be.spell && ! sSpellStore.LookupEntry(be.spell))
+                {
+                    sLog.outErrorDb("Table creature_movement_template references unknown spellid %u. Skipping id %u with point %u.", be.spell, entry, point);
+                    be.spell = 0;
+                }
 
-            if (be.emote)
-            {
-                if (!sEmotesStore.LookupEntry(be.emote))
-                    sLog.outErrorDb("Waypoint template path %u (point %u) are using emote %u, but emote does not exist.", entry, point, be.emote);
-            }
+                if (be.emote)
+                {
+                    if (!sEmotesStore.LookupEntry(be.emote))
+                        sLog.outErrorDb("Waypoint template path %u (point %u) are using emote %u, but emote does not exist.", entry, point, be.emote);
+                }
 
-            // save memory by not storing empty behaviors
-            if (!be.isEmpty())
-            {
-                node.behavior   = new WaypointBehavior(be);
-                ++total_behaviors;
+                // save memory by not storing empty behaviors
+                if (!be.isEmpty())
+                {
+                    node.behavior   = new WaypointBehavior(be);
+                    ++total_behaviors;
+                }
+                else
+                    node.behavior   = NULL;
             }
-            else
-                node.behavior   = NULL;
-        }
-        while (result->NextRow());
+            while (result->NextRow());
 
-        delete result;
+            delete result;
 
-        sLog.outString();
-        sLog.outString(">> Waypoint templates loaded");
-        sLog.outString();
-        sLog.outString(">>> Loaded %u path templates with %u nodes and %u behaviors", total_paths, total_nodes, total_behaviors);
+            sLog.outString();
+            sLog.outString(">> Waypoint templates loaded");
+            sLog.outString();
+            sLog.outString(">>> Loaded %u path templates with %u nodes and %u behaviors", total_paths, total_nodes, total_behaviors);
+        }
     }
 
     if (!movementScriptSet.empty())
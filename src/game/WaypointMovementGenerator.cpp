@@ -27,6 +27,8 @@
 #include "WaypointManager.h"
 #include "WorldPacket.h"
 #include "ScriptMgr.h"
+#include "World.h"
+#include "Map.h"
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
 
@@ -418,6 +420,8 @@ void FlightPathMovementGenerator::_Reset(Player& player)
     init.SetFly();
     init.SetVelocity(PLAYER_FLIGHT_SPEED);
     init.Launch();
+
+    PrefetchTerrain(player);
 }
 
 bool FlightPathMovementGenerator::Update(Player& player, const uint32& diff)
@@ -436,6 +440,8 @@ bool FlightPathMovementGenerator::Update(Player& player, const uint32& diff)
             departureEvent = !departureEvent;
         }
         while (true);
+
+        PrefetchTerrain(player);
     }
 
     return !(player.movespline->Finalized() || m_currentNode >= (m_path->size() - 1));
@@ -458,6 +464,28 @@ void FlightPathMovementGenerator::SetCurrentNodeAfterTeleport()
     }
 }
 
+void FlightPathMovementGenerator::PrefetchTerrain(Player& player) const
+{
+    float distance = sWorld.getConfig(CONFIG_FLOAT_GRID_PREFETCH_DISTANCE);
+    if (distance <= 0.0f)
+        return;
+
+    TerrainInfo* terrain = player.GetMap()->GetTerrain();
+    float x = player.GetPositionX();
+    float y = player.GetPositionY();
+
+    // taxi nodes are close enough to each other to not skip a grid
+    uint32 end = GetPathAtMapEnd();
+    for (uint32 i = GetCurrentNode(); i < end && distance > 0.0f; ++i)
+    {
+        TaxiPathNodeEntry const& node = (*m_path)[i];
+        distance -= sqrt((node.x - x) * (node.x - x) + (node.y - y) * (node.y - y));
+        x = node.x;
+        y = node.y;
+        terrain->Prefetch(x, y);
+    }
+}
+
 void FlightPathMovementGenerator::DoEventIfAny(Player& player, TaxiPathNodeEntry const& node, bool departure)
 {
     if (uint32 eventid = departure ? node.departureEventID : node.arrivalEventID)
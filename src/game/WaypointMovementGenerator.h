@@ -141,6 +141,8 @@ class MANGOS_DLL_SPEC FlightPathMovementGenerator :
         void _Interrupt(Player &);
         void _Reset(Player &);
 
+        // queue terrain of the next path nodes for the background terrain loader
+        void PrefetchTerrain(Player& player) const;
 };
 
 /** TransportPathMovementGenerator generates movement of the MO_TRANSPORT and elevators for the paths
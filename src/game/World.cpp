@@ -55,9 +55,11 @@
 #include "GameEventMgr.h"
 #include "PoolManager.h"
 #include "Database/DatabaseImpl.h"
+#include "Database/SQLStorageSnapshot.h"
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
 #include "MapPersistentStateMgr.h"
+#include "LoadGraph.h"
 #include "WaypointManager.h"
 #include "GMTicketMgr.h"
 #include "Util.h"
@@ -66,6 +68,7 @@
 #include "CreatureLinkingMgr.h"
 #include "Calendar.h"
 #include "Weather.h"
+#include "PacketCapture.h"
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -95,6 +98,7 @@ World::World()
     m_ShutdownTimer = 0;
     m_gameTime = time(NULL);
     m_startTime = m_gameTime;
+    m_characterDBQueueSize = 0;
     m_maxActiveSessionCount = 0;
     m_maxQueuedSessionCount = 0;
     m_NextDailyQuestReset = 0;
@@ -479,6 +483,20 @@ void World::LoadConfigSettings(bool reload)
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
+
+    setConfig(CONFIG_BOOL_DB_METRICS, "DatabaseMetrics", false);
+    WorldDatabase.GetMetrics().SetEnabled(getConfig(CONFIG_BOOL_DB_METRICS));
+    CharacterDatabase.GetMetrics().SetEnabled(getConfig(CONFIG_BOOL_DB_METRICS));
+    LoginDatabase.GetMetrics().SetEnabled(getConfig(CONFIG_BOOL_DB_METRICS));
+
+    setConfig(CONFIG_UINT32_DB_METRICS_DUMP_INTERVAL, "DatabaseMetrics.DumpInterval", 0);
+    if (reload && getConfig(CONFIG_UINT32_DB_METRICS_DUMP_INTERVAL))
+    {
+        m_timers[WUPDATE_DBMETRICS].SetInterval(getConfig(CONFIG_UINT32_DB_METRICS_DUMP_INTERVAL) * MINUTE * IN_MILLISECONDS);
+        m_timers[WUPDATE_DBMETRICS].Reset();
+    }
+
+    setConfigMinMax(CONFIG_UINT32_LOAD_THREADS, "LoadThreads", 1, 1, 32);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps", "");
@@ -495,8 +513,10 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
+    setConfig(CONFIG_UINT32_SAVE_MAX_QUEUE_SIZE, "PlayerSave.MaxQueueSize", 1000);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_GRIDCLEAN, "GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS, MIN_GRID_DELAY);
+    setConfigPos(CONFIG_FLOAT_GRID_PREFETCH_DISTANCE, "GridPrefetchDistance", 0.0f);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
@@ -505,6 +525,12 @@ void World::LoadConfigSettings(bool reload)
     setConfigMinMax(CONFIG_UINT32_MAPUPDATE_MAXVISITORS, "MapUpdate.MaxVisitorsInUpdate", 9, 1, 50);
     setConfigMinMax(CONFIG_UINT32_MAPUPDATE_MAXVISITS, "MapUpdate.MaxVisitsInUpdate", 20, 10, 100);
 
+    if (configNoReload(reload, CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0))
+        setConfigMinMax(CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0, 0, 256);
+
+    if (configNoReload(reload, CONFIG_UINT32_MAPUPDATE_GRID_THREADS, "MapUpdate.GridThreads", 0))
+        setConfigMinMax(CONFIG_UINT32_MAPUPDATE_GRID_THREADS, "MapUpdate.GridThreads", 0, 0, 256);
+
     setConfigMinMax(CONFIG_UINT32_POSITION_UPDATE_DELAY, "MapUpdate.PositionUpdateDelay", 400, 100, 2000);
 
     setConfigMinMax(CONFIG_UINT32_OBJECTLOADINGSPLITTER_ALLOWEDTIME, "ObjectLoadingSplitter.MaxAllowedTime", 10, 5, 1000);
@@ -935,6 +961,137 @@ void World::LoadConfigSettings(bool reload)
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
 
+    // a running capture is written out and a new one started with the current settings
+    sPacketCapture.Initialize();
+
+    sLog.outString();
+}
+
+static void LoadStageLootTables()
+{
+    sLog.outString("Loading Loot Tables...");
+    LoadLootTables();
+    sLog.outString(">>> Loot Tables loaded");
+    sLog.outString();
+}
+
+static void LoadStageSkillTables()
+{
+    sLog.outString("Loading Skill Discovery Table...");
+    sSpellMgr.LoadSkillDiscoveryTable();
+
+    sLog.outString("Loading Skill Extra Item Table...");
+    sSpellMgr.LoadSkillExtraItemTable();
+}
+
+static void LoadStageFishingSkillLevels()
+{
+    sLog.outString("Loading Skill Fishing base level requirements...");
+    sObjectMgr.LoadFishingBaseSkillLevel();
+}
+
+static void LoadStageAchievements()
+{
+    sLog.outString("Loading Achievements...");
+    sAchievementMgr.LoadAchievementReferenceList();
+    sAchievementMgr.LoadAchievementCriteriaList();
+    sAchievementMgr.LoadAchievementCriteriaRequirements();
+    sAchievementMgr.LoadRewards();
+    sAchievementMgr.LoadRewardLocales();
+    sAchievementMgr.LoadCompletedAchievements();
+    sLog.outString(">>> Achievements loaded");
+    sLog.outString();
+}
+
+static void LoadStageInstanceEncounters()
+{
+    sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
+    sObjectMgr.LoadInstanceEncounters();
+}
+
+static void LoadStageNpcGossips()
+{
+    sLog.outString("Loading Npc Text Id...");
+    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadGossipText
+}
+
+static void LoadStageGossipMenus()
+{
+    sLog.outString("Loading Gossip scripts...");
+    sScriptMgr.LoadGossipScripts();                         // must be before gossip menu options
+
+    sObjectMgr.LoadGossipMenus();
+}
+
+static void LoadStageVendors()
+{
+    sLog.outString("Loading Vendors...");
+    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
+    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
+}
+
+static void LoadStageTrainers()
+{
+    sLog.outString("Loading Trainers...");
+    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
+    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
+}
+
+static void LoadStageWaypoints()
+{
+    sLog.outString("Loading Waypoint scripts...");          // before loading from creature_movement
+    sScriptMgr.LoadCreatureMovementScripts();
+
+    sLog.outString("Loading Waypoints...");
+    sWaypointMgr.Load();
+}
+
+static void LoadStageReservedNames()
+{
+    sLog.outString("Loading ReservedNames...");
+    sObjectMgr.LoadReservedPlayersNames();
+}
+
+static void LoadStageGameObjectsForQuests()
+{
+    sLog.outString("Loading GameObjects for quests...");
+    sObjectMgr.LoadGameObjectForQuests();                   // must be after gameobject loot loading
+}
+
+static void LoadStageBattleMasters()
+{
+    sLog.outString("Loading BattleMasters...");
+    sBattleGroundMgr.LoadBattleMastersEntry();
+
+    sLog.outString("Loading BattleGround event indexes...");
+    sBattleGroundMgr.LoadBattleEventIndexes();
+}
+
+static void LoadStageGameTeleports()
+{
+    sLog.outString("Loading GameTeleports...");
+    sObjectMgr.LoadGameTele();
+}
+
+static void LoadStageCalendar()
+{
+    sLog.outString("Loading Calendar events/invites...");
+    sCalendarMgr.LoadFromDB();
+}
+
+static void LoadStageLocalization()
+{
+    ///- Loading localization data
+    sLog.outString("Loading Localization strings...");
+    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
+    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
+    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
+    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
+    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
+    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
+    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
+    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
+    sLog.outString(">>> Localization strings loaded");
     sLog.outString();
 }
 
@@ -996,6 +1153,19 @@ void World::SetInitialWorldSettings()
     DetectDBCLang();
     sObjectMgr.SetDBCLocaleIndex(GetDefaultDbcLocale());    // Get once for all the locale index of DBC language (console/broadcasts)              
 
+    ///- Template tables may be restored from the snapshot of a previous start
+    std::string snapshotFile = sConfig.GetStringDefault("StaticDataSnapshot", "");
+    if (!snapshotFile.empty())
+    {
+        // script ids stored in the templates depend on the script names of all these tables
+        static char const* const snapshotDependencies[] =
+        {
+            "creature_template", "gameobject_template", "item_template", "scripted_areatrigger",
+            "scripted_event_id", "instance_template", "world_template"
+        };
+        sStorageSnapshot.Open(snapshotFile.c_str(), WorldDatabase, snapshotDependencies, countof(snapshotDependencies));
+    }
+
     sLog.outString("Loading SpellDbc...");
     sSpellMgr.LoadSpellDbc();
 
@@ -1172,6 +1342,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Conditions...");
     sObjectMgr.LoadConditions();
 
+    // all template storages are loaded
+    sStorageSnapshot.Close();
+
     sLog.outString("Creating map persistent states for non-instanceable maps...");     // must be after PackInstances(), LoadCreatures(), sPoolMgr.LoadFromDB(), sGameEventMgr.LoadFromDB();
     sMapPersistentStateMgr.InitWorldMaps();
     sLog.outString();
@@ -1241,85 +1414,27 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player level dependent mail rewards...");
     sObjectMgr.LoadMailLevelRewards();
 
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Discovery Table...");
-    sSpellMgr.LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    sSpellMgr.LoadSkillExtraItemTable();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Achievements...");
-    sAchievementMgr.LoadAchievementReferenceList();
-    sAchievementMgr.LoadAchievementCriteriaList();
-    sAchievementMgr.LoadAchievementCriteriaRequirements();
-    sAchievementMgr.LoadRewards();
-    sAchievementMgr.LoadRewardLocales();
-    sAchievementMgr.LoadCompletedAchievements();
-    sLog.outString(">>> Achievements loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
-    sObjectMgr.LoadInstanceEncounters();
-
-    sLog.outString("Loading Npc Text Id...");
-    sObjectMgr.LoadNpcGossips();                            // must be after load Creature and LoadGossipText
-
-    sLog.outString("Loading Gossip scripts...");
-    sScriptMgr.LoadGossipScripts();                         // must be before gossip menu options
-
-    sObjectMgr.LoadGossipMenus();
-
-    sLog.outString("Loading Vendors...");
-    sObjectMgr.LoadVendorTemplates();                       // must be after load ItemTemplate
-    sObjectMgr.LoadVendors();                               // must be after load CreatureTemplate, VendorTemplate, and ItemTemplate
-
-    sLog.outString("Loading Trainers...");
-    sObjectMgr.LoadTrainerTemplates();                      // must be after load CreatureTemplate
-    sObjectMgr.LoadTrainers();                              // must be after load CreatureTemplate, TrainerTemplate
-
-    sLog.outString("Loading Waypoint scripts...");          // before loading from creature_movement
-    sScriptMgr.LoadCreatureMovementScripts();
-
-    sLog.outString("Loading Waypoints...");
-    sWaypointMgr.Load();
-
-    sLog.outString("Loading ReservedNames...");
-    sObjectMgr.LoadReservedPlayersNames();
-
-    sLog.outString("Loading GameObjects for quests...");
-    sObjectMgr.LoadGameObjectForQuests();
-
-    sLog.outString("Loading BattleMasters...");
-    sBattleGroundMgr.LoadBattleMastersEntry();
-
-    sLog.outString("Loading BattleGround event indexes...");
-    sBattleGroundMgr.LoadBattleEventIndexes();
-
-    sLog.outString("Loading GameTeleports...");
-    sObjectMgr.LoadGameTele();
-
-    sLog.outString("Loading Calendar events/invites...");
-    sCalendarMgr.LoadFromDB();
-
-    ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
+    ///- Static data without dependencies between each other, run in parallel with LoadThreads > 1
+    LoadGraph staticData("static data tables");
+    staticData.AddStage("Loot Tables", &LoadStageLootTables);
+    staticData.AddStage("Skill tables", &LoadStageSkillTables);
+    staticData.AddStage("Fishing skill levels", &LoadStageFishingSkillLevels);
+    staticData.AddStage("Achievements", &LoadStageAchievements);
+    staticData.AddStage("Instance encounters", &LoadStageInstanceEncounters);
+    staticData.AddStage("Npc Text Id", &LoadStageNpcGossips);
+    staticData.AddStage("Gossip menus", &LoadStageGossipMenus);
+    staticData.AddStage("Vendors", &LoadStageVendors);
+    staticData.AddStage("Trainers", &LoadStageTrainers);
+    // script maps of ScriptMgr are filled without locking
+    staticData.AddStage("Waypoints", &LoadStageWaypoints, "Gossip menus");
+    staticData.AddStage("ReservedNames", &LoadStageReservedNames);
+    staticData.AddStage("GameObjects for quests", &LoadStageGameObjectsForQuests, "Loot Tables");
+    staticData.AddStage("BattleMasters", &LoadStageBattleMasters);
+    staticData.AddStage("GameTeleports", &LoadStageGameTeleports);
+    staticData.AddStage("Calendar", &LoadStageCalendar);
+    // locale indexes are assigned by the first loader using them, achievement reward locales included
+    staticData.AddStage("Localization strings", &LoadStageLocalization, "Gossip menus", "Achievements");
+    staticData.Run(getConfig(CONFIG_UINT32_LOAD_THREADS));
 
     sLog.outString("Loading LFG rewards...");               // After load all static data
     sLFGMgr.LoadRewards();
@@ -1428,6 +1543,10 @@ void World::SetInitialWorldSettings()
     m_timers[WUPDATE_CALENDAR].SetInterval(sConfig.GetIntDefault("Calendar.Timer", 30000));
     m_timers[WUPDATE_CALENDAR].Reset();
 
+    // interval 0 disables the dump, the timer is not checked then
+    m_timers[WUPDATE_DBMETRICS].SetInterval(getConfig(CONFIG_UINT32_DB_METRICS_DUMP_INTERVAL) * MINUTE * IN_MILLISECONDS);
+    m_timers[WUPDATE_DBMETRICS].Reset();
+
     // to set mailtimer to return mails every day between 4 and 5 am
     // mailtimer is increased when updating auctions
     // one second is 1000 -(tested on win system)
@@ -1630,7 +1749,23 @@ void World::Update(uint32 diff)
         LoginDatabase.PExecute("UPDATE uptime SET uptime = %u, maxplayers = %u WHERE realmid = %u AND starttime = " UI64FMTD, tmpDiff, maxClientsNum, getConfig(CONFIG_UINT32_REALMID), uint64(m_startTime));
     }
 
+    /// <li> Dump the database metrics of the last interval
+    if (getConfig(CONFIG_BOOL_DB_METRICS) && getConfig(CONFIG_UINT32_DB_METRICS_DUMP_INTERVAL) && m_timers[WUPDATE_DBMETRICS].Passed())
+    {
+        m_timers[WUPDATE_DBMETRICS].Reset();
+
+        std::vector<std::string> lines;
+        GetDatabaseMetricsReport(lines, 20);
+        ResetDatabaseMetrics();
+
+        for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+            sLog.outString("%s", itr->c_str());
+    }
+
     /// <li> Handle all other objects
+    // players decide about their autosaves in map update
+    m_characterDBQueueSize = CharacterDatabase.GetAsyncQueueSize();
+
     ///- Update objects (maps, transport, creatures,...)
     sMapMgr.Update(diff);
     sBattleGroundMgr.Update(diff);
@@ -2057,6 +2192,55 @@ void World::ShutdownCancel()
     DEBUG_LOG("Server %s cancelled.", (m_ShutdownMask & SHUTDOWN_MASK_RESTART ? "restart" : "shutdown"));
 }
 
+uint32 World::GetAutoSaveDelay(uint32 lowGuid) const
+{
+    uint32 interval = getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    if (!interval)
+        return 0;
+
+    // every character gets a fixed save time inside the interval, the multiplicative hash
+    // distributes consecutive guids evenly so saves don't depend on when characters logged in
+    uint32 phase = uint32((uint64(lowGuid * 2654435761U) * interval) >> 32);
+    uint32 delay = interval - (WorldTimer::getMSTime() + phase) % interval;
+
+    // not much earlier than a full interval after the previous save
+    if (delay < interval / 2)
+        delay += interval;
+
+    return delay;
+}
+
+uint32 World::GetAutoSaveThrottleDelay() const
+{
+    uint32 maxQueueSize = getConfig(CONFIG_UINT32_SAVE_MAX_QUEUE_SIZE);
+    if (!maxQueueSize || m_characterDBQueueSize <= maxQueueSize)
+        return 0;
+
+    // the longer the queue, the wider the postponed saves are spread, up to one save interval
+    uint32 maxDelay = 10 * IN_MILLISECONDS * (m_characterDBQueueSize / maxQueueSize);
+    if (uint32 interval = getConfig(CONFIG_UINT32_INTERVAL_SAVE))
+        maxDelay = std::min(maxDelay, interval);
+
+    return urand(std::min(uint32(IN_MILLISECONDS), maxDelay), maxDelay);
+}
+
+void World::GetDatabaseMetricsReport(std::vector<std::string>& lines, uint32 maxEntries) const
+{
+    lines.push_back("World database:");
+    WorldDatabase.GetMetrics().Report(lines, maxEntries);
+    lines.push_back("Character database:");
+    CharacterDatabase.GetMetrics().Report(lines, maxEntries);
+    lines.push_back("Login database:");
+    LoginDatabase.GetMetrics().Report(lines, maxEntries);
+}
+
+void World::ResetDatabaseMetrics()
+{
+    WorldDatabase.GetMetrics().Reset();
+    CharacterDatabase.GetMetrics().Reset();
+    LoginDatabase.GetMetrics().Reset();
+}
+
 void World::UpdateSessions(uint32 /*diff*/)
 {
     ///- Add new sessions
@@ -83,7 +83,8 @@ enum WorldTimers
     WUPDATE_GROUPS      = 6,
     WUPDATE_WORLDSTATE  = 7,
     WUPDATE_CALENDAR    = 8,
-    WUPDATE_COUNT       = 9
+    WUPDATE_DBMETRICS   = 9,
+    WUPDATE_COUNT       = 10
 };
 
 /// Configuration elements
@@ -97,6 +98,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_MAPUPDATE_MAXVISITORS,
     CONFIG_UINT32_MAPUPDATE_MAXVISITS,
+    CONFIG_UINT32_MAPUPDATE_THREADS,
+    CONFIG_UINT32_MAPUPDATE_GRID_THREADS,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
     CONFIG_UINT32_REALM_ZONE,
@@ -143,6 +146,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MAIL_DELIVERY_DELAY,
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
+    CONFIG_UINT32_DB_METRICS_DUMP_INTERVAL,
+    CONFIG_UINT32_LOAD_THREADS,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
@@ -194,6 +199,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_TIMERBAR_FIRE_GMLEVEL,
     CONFIG_UINT32_TIMERBAR_FIRE_MAX,
     CONFIG_UINT32_MIN_LEVEL_STAT_SAVE,
+    CONFIG_UINT32_SAVE_MAX_QUEUE_SIZE,
     CONFIG_UINT32_CHARDELETE_KEEP_DAYS,
     CONFIG_UINT32_CHARDELETE_METHOD,
     CONFIG_UINT32_CHARDELETE_MIN_LEVEL,
@@ -304,6 +310,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
     CONFIG_FLOAT_MELEE_DIST_ADDITION,
     CONFIG_FLOAT_CROWDCONTROL_HP_BASE,
+    CONFIG_FLOAT_GRID_PREFETCH_DISTANCE,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -370,6 +377,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
+    CONFIG_BOOL_DB_METRICS,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
     CONFIG_BOOL_LOOT_CHESTS_IGNORE_DB,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
@@ -581,6 +589,16 @@ class World
 
         void UpdateSessions(uint32 diff);
 
+        /// Time until the next autosave of a character, spreads the saves of all characters uniformly over the save interval
+        uint32 GetAutoSaveDelay(uint32 lowGuid) const;
+        /// Time to postpone a due autosave while the character database can't keep up with async requests, 0 if not needed
+        uint32 GetAutoSaveThrottleDelay() const;
+        /// Async requests waiting for execution by the character database, sampled every world tick
+        uint32 GetCharacterDBQueueSize() const { return m_characterDBQueueSize; }
+        /// Append the operation metrics of all databases, at most maxEntries statements per database
+        void GetDatabaseMetricsReport(std::vector<std::string>& lines, uint32 maxEntries) const;
+        void ResetDatabaseMetrics();
+
         /// Get a server configuration element (see #eConfigFloatValues)
         void setConfig(eConfigFloatValues index, float value) { m_configFloatValues[index] = value; }
         /// Get a server configuration element (see #eConfigFloatValues)
@@ -694,6 +712,7 @@ class World
 
         time_t m_startTime;
         time_t m_gameTime;
+        uint32 m_characterDBQueueSize;
         IntervalTimer m_timers[WUPDATE_COUNT];
         uint32 mail_timer;
         uint32 mail_timer_expires;
@@ -729,7 +748,7 @@ class World
         static uint32 m_relocation_ai_notify_delay;
 
         // CLI command holder to be thread safe
-        MaNGOS::LockedQueue<CliCommandHolder*, boost::mutex> cliCmdQueue;
+        MaNGOS::MPSCQueue<CliCommandHolder*> cliCmdQueue;
 
         // next daily quests reset time
         time_t m_NextDailyQuestReset;
@@ -742,7 +761,7 @@ class World
 
         // sessions that are added async
         void AddSession_(WorldSession* s);
-        MaNGOS::LockedQueue<WorldSession*, boost::mutex> addSessQueue;
+        MaNGOS::MPSCQueue<WorldSession*> addSessQueue;
 
         // used versions
         std::string m_DBVersion;
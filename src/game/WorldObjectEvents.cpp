@@ -397,7 +397,10 @@ bool EvadeDelayEvent::Execute(uint64 /*e_time*/, uint32 /*p_time*/)
             c_owner->LockAI(false);
 
             if (InstanceData* mapInstance = c_owner->GetInstanceData())
+            {
+                Map::ScriptGuard guard(*c_owner->GetMap());
                 mapInstance->OnCreatureEvade(c_owner);
+            }
             break;
         }
         case HIGHGUID_PET:
@@ -426,7 +429,10 @@ bool EvadeDelayEvent::Execute(uint64 /*e_time*/, uint32 /*p_time*/)
             if (petOwner && petOwner->GetTypeId() == TYPEID_UNIT)
             {
                 if (InstanceData* mapInstance = c_owner->GetInstanceData())
+                {
+                    Map::ScriptGuard guard(*c_owner->GetMap());
                     mapInstance->OnCreatureEvade(c_owner);
+                }
             }
             break;
         }
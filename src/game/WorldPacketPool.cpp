@@ -0,0 +1,154 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldPacketPool.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+static const size_t s_sizeClassBytes[WORLD_PACKET_POOL_SIZE_CLASSES] = { 64, 256, 1024, 4096 };
+
+class PooledWorldPacket : public WorldPacket
+{
+    public:
+        PooledWorldPacket(WorldPacketPool* pool, uint8 sizeClass, Opcodes opcode, size_t size)
+            : WorldPacket(opcode, size), m_pool(pool), m_sizeClass(sizeClass), m_nextFree(NULL) {}
+
+        WorldPacketPool* m_pool;                            // NULL for not pooled packet
+        uint8 m_sizeClass;
+        PooledWorldPacket* m_nextFree;
+};
+
+boost::thread_specific_ptr<WorldPacketPool> WorldPacketPool::m_threadPool(&WorldPacketPool::NoPoolCleanup);
+
+// all created pools, packets can outlive the network thread that allocated them
+static std::vector<WorldPacketPool*> s_pools;
+static boost::mutex s_poolsLock;
+
+WorldPacketPool::WorldPacketPool() : m_returned(NULL), m_hits(0), m_misses(0)
+{
+    for (int i = 0; i < WORLD_PACKET_POOL_SIZE_CLASSES; ++i)
+    {
+        m_free[i] = NULL;
+        m_freeCount[i] = 0;
+    }
+}
+
+WorldPacketPool::~WorldPacketPool()
+{
+}
+
+WorldPacket* WorldPacketPool::Acquire(Opcodes opcode, size_t size)
+{
+    WorldPacketPool* pool = m_threadPool.get();
+    if (!pool)
+    {
+        pool = new WorldPacketPool();
+        m_threadPool.reset(pool);
+
+        boost::lock_guard<boost::mutex> guard(s_poolsLock);
+        s_pools.push_back(pool);
+    }
+
+    uint8 sizeClass = 0;
+    while (sizeClass < WORLD_PACKET_POOL_SIZE_CLASSES && s_sizeClassBytes[sizeClass] < size)
+        ++sizeClass;
+
+    if (sizeClass == WORLD_PACKET_POOL_SIZE_CLASSES)
+    {
+        pool->m_misses.fetch_add(1, boost::memory_order_relaxed);
+        return new PooledWorldPacket(NULL, 0, opcode, size);
+    }
+
+    if (PooledWorldPacket* packet = pool->Take(sizeClass))
+    {
+        pool->m_hits.fetch_add(1, boost::memory_order_relaxed);
+        packet->Initialize(opcode, size);
+        return packet;
+    }
+
+    pool->m_misses.fetch_add(1, boost::memory_order_relaxed);
+    return new PooledWorldPacket(pool, sizeClass, opcode, s_sizeClassBytes[sizeClass]);
+}
+
+void WorldPacketPool::Release(WorldPacket* packet)
+{
+    if (!packet)
+        return;
+
+    PooledWorldPacket* pooled = static_cast<PooledWorldPacket*>(packet);
+    WorldPacketPool* pool = pooled->m_pool;
+    if (!pool)
+    {
+        delete pooled;
+        return;
+    }
+
+    pooled->m_nextFree = pool->m_returned.load(boost::memory_order_relaxed);
+    while (!pool->m_returned.compare_exchange_weak(pooled->m_nextFree, pooled, boost::memory_order_release, boost::memory_order_relaxed))
+        ;
+}
+
+void WorldPacketPool::GetStats(uint64& hits, uint64& misses)
+{
+    hits = 0;
+    misses = 0;
+
+    boost::lock_guard<boost::mutex> guard(s_poolsLock);
+    for (std::vector<WorldPacketPool*>::const_iterator itr = s_pools.begin(); itr != s_pools.end(); ++itr)
+    {
+        hits += (*itr)->m_hits.load(boost::memory_order_relaxed);
+        misses += (*itr)->m_misses.load(boost::memory_order_relaxed);
+    }
+}
+
+PooledWorldPacket* WorldPacketPool::Take(uint8 sizeClass)
+{
+    if (!m_free[sizeClass])
+        CollectReturned();
+
+    PooledWorldPacket* packet = m_free[sizeClass];
+    if (packet)
+    {
+        m_free[sizeClass] = packet->m_nextFree;
+        --m_freeCount[sizeClass];
+    }
+
+    return packet;
+}
+
+void WorldPacketPool::CollectReturned()
+{
+    // whole list is taken at once, so no ABA problem with concurrent pushes
+    PooledWorldPacket* packet = m_returned.exchange(NULL, boost::memory_order_acquire);
+    while (packet)
+    {
+        PooledWorldPacket* next = packet->m_nextFree;
+        uint8 sizeClass = packet->m_sizeClass;
+
+        if (m_freeCount[sizeClass] < WORLD_PACKET_POOL_MAX_FREE)
+        {
+            packet->m_nextFree = m_free[sizeClass];
+            m_free[sizeClass] = packet;
+            ++m_freeCount[sizeClass];
+        }
+        else
+            delete packet;
+
+        packet = next;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLDPACKETPOOL_H
+#define MANGOS_WORLDPACKETPOOL_H
+
+#include "Common.h"
+#include "WorldPacket.h"
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/tss.hpp>
+
+class PooledWorldPacket;
+
+enum
+{
+    WORLD_PACKET_POOL_SIZE_CLASSES  = 4,                    // 64, 256, 1024 and 4096 bytes
+    WORLD_PACKET_POOL_MAX_FREE      = 1024                  // max free packets kept per size class and thread
+};
+
+/**
+ * Pool of incoming client packets.
+ *
+ * Every network thread gets its own pool on first Acquire(), so taking a packet
+ * needs no locking. Packets are returned by world/map threads after handling,
+ * they are pushed onto a lock-free list of the owning pool and picked up by the
+ * network thread when its free list of the size class runs empty. Packets bigger
+ * than the largest size class are not pooled.
+ */
+class WorldPacketPool : public boost::noncopyable
+{
+    public:
+        /// Get empty packet with at least size bytes reserved, from pool of current thread
+        static WorldPacket* Acquire(Opcodes opcode, size_t size);
+        /// Give back packet got by Acquire(), may be called from any thread
+        static void Release(WorldPacket* packet);
+
+        /// Sum of counters of all pools
+        static void GetStats(uint64& hits, uint64& misses);
+
+    private:
+        WorldPacketPool();
+        ~WorldPacketPool();
+
+        PooledWorldPacket* Take(uint8 sizeClass);
+        void CollectReturned();
+
+        static void NoPoolCleanup(WorldPacketPool*) {}      // pools live until process exit, see Acquire()
+
+        PooledWorldPacket* m_free[WORLD_PACKET_POOL_SIZE_CLASSES];      // owner thread only
+        uint32 m_freeCount[WORLD_PACKET_POOL_SIZE_CLASSES];
+        boost::atomic<PooledWorldPacket*> m_returned;                  // pushed by any thread
+
+        boost::atomic<uint64> m_hits;
+        boost::atomic<uint64> m_misses;
+
+        static boost::thread_specific_ptr<WorldPacketPool> m_threadPool;
+};
+
+/// Releases incoming packet on scope exit unless ownership was passed on with release()
+class WorldPacketPoolGuard : public boost::noncopyable
+{
+    public:
+        explicit WorldPacketPoolGuard(WorldPacket* packet) : m_packet(packet) {}
+        ~WorldPacketPoolGuard() { if (m_packet) WorldPacketPool::Release(m_packet); }
+
+        WorldPacket* release() { WorldPacket* packet = m_packet; m_packet = NULL; return packet; }
+
+    private:
+        WorldPacket* m_packet;
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include "Log.h"
 #include "Opcodes.h"
 #include "WorldPacket.h"
+#include "WorldPacketPool.h"
 #include "WorldSession.h"
 #include "Player.h"
 #include "ObjectMgr.h"
@@ -112,7 +113,10 @@ WorldSession::~WorldSession()
     ///- empty incoming packet queue
     WorldPacket* packet = NULL;
     while (_recvQueue.next(packet))
-        delete packet;
+        WorldPacketPool::Release(packet);
+
+    for (std::deque<WorldPacket*>::const_iterator itr = _throttledQueue.begin(); itr != _throttledQueue.end(); ++itr)
+        WorldPacketPool::Release(*itr);
 }
 
 void WorldSession::SizeError(WorldPacket const& packet, uint32 size) const
@@ -129,6 +133,17 @@ char const* WorldSession::GetPlayerName() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    SendPacket(*packet, NULL);
+}
+
+/// Send a shared packet to the client, payload is not copied when large enough
+void WorldSession::SendPacket(SharedWorldPacket const& packet)
+{
+    SendPacket(*packet, &packet);
+}
+
+void WorldSession::SendPacket(WorldPacket const& packet, SharedWorldPacket const* shared)
 {
     if (!m_Socket)
         return;
@@ -150,10 +165,10 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     if ((cur_time - lastTime) < 60)
     {
         sendPacketCount += 1;
-        sendPacketBytes += packet->size();
+        sendPacketBytes += packet.size();
 
         sendLastPacketCount += 1;
-        sendLastPacketBytes += packet->size();
+        sendLastPacketBytes += packet.size();
     }
     else
     {
@@ -164,21 +179,109 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 
         lastTime = cur_time;
         sendLastPacketCount = 1;
-        sendLastPacketBytes = packet->wpos();               // wpos is real written size
+        sendLastPacketBytes = packet.wpos();                // wpos is real written size
     }
 
 #endif                                                  // !MANGOS_DEBUG
 
-    if (!m_Socket->SendPacket(*packet))
+    bool sent = shared ? m_Socket->SendPacket(*shared) : m_Socket->SendPacket(packet);
+    if (!sent)
         m_Socket->CloseSocket();
 }
 
+void WorldPacketBroadcast::SendTo(WorldSession* session)
+{
+    // tiny payloads are cheaper to copy than to share, see protocol::SEND_REFERENCE_MIN_SIZE
+    if (m_packet.size() < protocol::SEND_REFERENCE_MIN_SIZE)
+    {
+        session->SendPacket(&m_packet);
+        return;
+    }
+
+    if (!m_shared)
+        m_shared.reset(new WorldPacket(m_packet));
+
+    session->SendPacket(m_shared);
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
     _recvQueue.add(new_packet);
 }
 
+/// Client requests answered with much output (queries, listings)
+static bool IsOutputRequest(uint16 opcode)
+{
+    switch (opcode)
+    {
+        case CMSG_NAME_QUERY:
+        case CMSG_CREATURE_QUERY:
+        case CMSG_GAMEOBJECT_QUERY:
+        case CMSG_ITEM_QUERY_SINGLE:
+        case CMSG_ITEM_NAME_QUERY:
+        case CMSG_ITEM_TEXT_QUERY:
+        case CMSG_QUEST_QUERY:
+        case CMSG_QUESTGIVER_STATUS_MULTIPLE_QUERY:
+        case CMSG_NPC_TEXT_QUERY:
+        case CMSG_PAGE_TEXT_QUERY:
+        case CMSG_PET_NAME_QUERY:
+        case CMSG_GUILD_QUERY:
+        case CMSG_GUILD_ROSTER:
+        case CMSG_GUILD_BANK_QUERY_TAB:
+        case CMSG_ARENA_TEAM_ROSTER:
+        case CMSG_WHO:
+        case CMSG_AUCTION_LIST_ITEMS:
+        case CMSG_AUCTION_LIST_BIDDER_ITEMS:
+        case CMSG_AUCTION_LIST_OWNER_ITEMS:
+        case CMSG_AUCTION_LIST_PENDING_SALES:
+        case CMSG_GET_MAIL_LIST:
+        case CMSG_LIST_INVENTORY:
+        case CMSG_CALENDAR_GET_CALENDAR:
+        case CMSG_QUERY_INSPECT_ACHIEVEMENTS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Next packet to handle: while the client can't keep up with our output, requests that
+/// would only add more of it are held back, all other packets are handled as usual
+bool WorldSession::NextPacket(WorldPacket*& packet, PacketFilter& updater)
+{
+    bool congested = m_Socket->IsSendCongested();
+
+    // held back requests come first once output drained
+    if (!congested && !_throttledQueue.empty())
+    {
+        if (!updater.Process(_throttledQueue.front()))
+            return false;
+
+        packet = _throttledQueue.front();
+        _throttledQueue.pop_front();
+        return true;
+    }
+
+    while (_recvQueue.next(packet, updater))
+    {
+        if (!congested || !IsOutputRequest(packet->GetOpcode()))
+            return true;
+
+        if (_throttledQueue.size() >= MAX_THROTTLED_PACKETS)
+        {
+            sLog.outError("WorldSession::Update client %s (account %u) keeps sending requests while not reading output, disconnecting.",
+                          GetRemoteAddress().c_str(), GetAccountId());
+            WorldPacketPool::Release(packet);
+            KickPlayer();
+            return false;
+        }
+
+        _throttledQueue.push_back(packet);
+    }
+
+    return false;
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, const char* reason)
 {
@@ -203,7 +306,7 @@ bool WorldSession::Update(PacketFilter& updater)
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
     WorldPacket* packet = NULL;
-    while (m_Socket && !m_Socket->IsClosed() && _recvQueue.next(packet, updater))
+    while (m_Socket && !m_Socket->IsClosed() && NextPacket(packet, updater))
     {
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -296,7 +399,7 @@ bool WorldSession::Update(PacketFilter& updater)
             }
         }
 
-        delete packet;
+        WorldPacketPool::Release(packet);
     }
 
     ///- Cleanup socket pointer if need
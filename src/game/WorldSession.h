@@ -25,10 +25,12 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <deque>
 
 #include "Common.h"
 #include "SharedDefines.h"
 #include "ObjectGuid.h"
+#include "WorldPacketFwd.h"
 #include "AuctionHouseMgr.h"
 #include "Item.h"
 #include "LFG.h"
@@ -46,7 +48,6 @@ class Item;
 class Object;
 class Player;
 class Unit;
-class WorldPacket;
 class WorldSocket;
 class QueryResult;
 class LoginQueryHolder;
@@ -219,6 +220,7 @@ class MANGOS_DLL_SPEC WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const* packet);
+        void SendPacket(SharedWorldPacket const& packet);
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName* declinedName);
@@ -908,6 +910,12 @@ class MANGOS_DLL_SPEC WorldSession
         void UpdateMoverPosition(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
+        // held back requests above this count disconnect the client, see NextPacket
+        enum { MAX_THROTTLED_PACKETS = 500 };
+        bool NextPacket(WorldPacket*& packet, PacketFilter& updater);
+
+        // common send path of both SendPacket overloads, shared is the owner of packet if set
+        void SendPacket(WorldPacket const& packet, SharedWorldPacket const* shared);
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* reason);
@@ -936,7 +944,22 @@ class MANGOS_DLL_SPEC WorldSession
         uint32 m_Tutorials[8];
         TutorialDataState m_tutorialState;
         AddonsList m_addonsList;
-        MaNGOS::LockedQueue<WorldPacket*, boost::mutex> _recvQueue;
+        MaNGOS::MPSCQueue<WorldPacket*> _recvQueue;         // filled by network thread, read by world or map update (never both at once)
+        std::deque<WorldPacket*> _throttledQueue;           // requests held back from _recvQueue while socket output is congested
+};
+
+/// Sends one packet to many sessions. Large payload is copied once into a shared
+/// packet on first send and then queued by reference in every receiver socket.
+class MANGOS_DLL_SPEC WorldPacketBroadcast
+{
+    public:
+        explicit WorldPacketBroadcast(WorldPacket const& packet) : m_packet(packet) {}
+
+        void SendTo(WorldSession* session);
+
+    private:
+        WorldPacket const& m_packet;
+        SharedWorldPacket m_shared;
 };
 #endif
 /// @}
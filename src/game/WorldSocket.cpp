@@ -22,6 +22,8 @@
 #include "Util.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include "WorldPacketPool.h"
+#include "PacketCapture.h"
 #include "SharedDefines.h"
 #include "ByteBuffer.h"
 #include "Opcodes.h"
@@ -114,7 +116,7 @@ m_Seed(static_cast<uint32>(rand32()))
 
 WorldSocket::~WorldSocket(void)
 {
-    delete m_RecvWPct;
+    WorldPacketPool::Release(m_RecvWPct);
 }
 
 void WorldSocket::CloseSocket(void)
@@ -139,9 +141,37 @@ bool WorldSocket::SendPacket(const WorldPacket& pct)
 
     if (!AppendPacket(pct))
     {
-        sLog.outError("network write buffer is too small to accommodate packet. Disconnecting client");
+        sLog.outError("network write buffer hard limit reached, client doesn't receive data. Disconnecting client");
         return false;
     }
+
+    // only queued packets, captured under the output lock to keep the send order
+    if (sPacketCapture.IsActive())
+        sPacketCapture.Capture(native_handle(), GetRemoteAddress(), pct, false);
+
+    StartAsyncSend();
+    return true;
+}
+
+bool WorldSocket::SendPacket(const SharedWorldPacket& pct)
+{
+    if (IsClosed())
+        return false;
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(native_handle(), pct->GetOpcode(), pct->GetOpcodeName(), pct.get(), false);
+
+    GuardType Guard(out_buffer_lock_);
+
+    if (!AppendPacket(*pct, &pct))
+    {
+        sLog.outError("network write buffer hard limit reached, client doesn't receive data. Disconnecting client");
+        return false;
+    }
+
+    if (sPacketCapture.IsActive())
+        sPacketCapture.Capture(native_handle(), GetRemoteAddress(), *pct, false);
+
     StartAsyncSend();
     return true;
 }
@@ -247,7 +277,7 @@ int WorldSocket::handle_input_header(void)
 
     header.size -= 4;
 
-    m_RecvWPct = new WorldPacket((Opcodes)header.cmd, header.size);
+    m_RecvWPct = WorldPacketPool::Acquire((Opcodes)header.cmd, header.size);
 
     if (header.size > 0)
     {
@@ -287,7 +317,7 @@ int WorldSocket::handle_input_payload(void)
 int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
 {
     // manage memory ;)
-    std::auto_ptr<WorldPacket> aptr(new_pct);
+    WorldPacketPoolGuard aptr(new_pct);
 
     const uint16 opcode = new_pct->GetOpcode();
 
@@ -302,6 +332,8 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
 
     // Dump received packet.
     sLog.outWorldPacketDump(native_handle(), new_pct->GetOpcode(), new_pct->GetOpcodeName(), new_pct, true);
+    if (sPacketCapture.IsActive())
+        sPacketCapture.Capture(native_handle(), GetRemoteAddress(), *new_pct, true);
 
     try
     {
@@ -644,32 +676,25 @@ int WorldSocket::HandlePing(WorldPacket& recvPacket)
     return 0;
 }
 
-bool WorldSocket::AppendPacket(const WorldPacket &pct)
+bool WorldSocket::AppendPacket(const WorldPacket &pct, const SharedWorldPacket* shared)
 {
     ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
+
+    // check before encryption, skipped header would break crypt state
+    if (!CanQueueOutgoing(pct.size() + header.getHeaderLength()))
+        return false;
+
     m_Crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
 
-    if (out_buffer_->space() >= pct.size() + header.getHeaderLength())
-    {
-        // Put the packet on the buffer.
-        if (!out_buffer_->Write(header.header, header.getHeaderLength()))
-        {
-            MANGOS_ASSERT(false);
-            return false;
-        }
+    // Put the packet on the buffer.
+    out_buffer_.Write(header.header, header.getHeaderLength());
 
-        if (!pct.empty() && !out_buffer_->Write(pct.contents(), pct.size()))
-        {
-            MANGOS_ASSERT(false);
-            return false;
-        }
-    }
-    else
-    {
-        // Enqueue the packet.
-        MANGOS_ASSERT(false);
-        return false;
-    }
+    // payload is sent unencrypted, so shared one can be queued by reference for all receivers
+    if (shared && pct.size() >= protocol::SEND_REFERENCE_MIN_SIZE)
+        out_buffer_.Append(*shared);
+    else if (!pct.empty())
+        out_buffer_.Write(pct.contents(), pct.size());
 
+    UpdateSendCongestion();
     return true;
 }
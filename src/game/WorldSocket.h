@@ -34,8 +34,8 @@
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
 #include "Auth/BigNumber.h"
+#include "WorldPacket.h"
 
-class WorldPacket;
 class WorldSession;
 class NetworkThread;
 class WorldSocketMgr;
@@ -48,11 +48,16 @@ class WorldSocketMgr;
 * Most methods return -1 on failure.
 * The class uses reference counting.
 *
-* For output the class uses one buffer (64K usually) and
-* a queue where it stores packet if there is no place on
-* the queue. The reason this is done, is because the server
-* does really a lot of small-size writes to it, and it doesn't
-* scale well to allocate memory for every. When something is
+* For output the class uses a chain of pooled 4K buffers
+* (see NetworkBufferChain), taken from the pool on demand and
+* returned when sent, so idle connection holds no output memory.
+* The server does really a lot of small-size writes to it, and
+* packets are packed into the buffers, not allocated one by one.
+* Payloads of shared broadcast packets are not copied at all,
+* they are queued by reference next to the encrypted header.
+* Queued output above Network.OutUBuff marks the socket as
+* congested (WorldSession holds back queries until it drains),
+* above Network.OutUBuffHardLimit the client is disconnected. When something is
 * written to the output buffer the socket is not immediately
 * activated for output (again for the same reason), there
 * is 10ms celling (thats why there is Update() override method).
@@ -87,6 +92,12 @@ public:
     /// @return false of failure
     bool SendPacket(const WorldPacket& pct);
 
+    /// Send a shared packet, its payload is queued by reference when large enough
+    /// and only the header is encrypted per connection.
+    /// @param pct packet to send
+    /// @return false of failure
+    bool SendPacket(const SharedWorldPacket& pct);
+
     /// Return the session key
     BigNumber& GetSessionKey() { return m_s; }
 
@@ -116,7 +127,7 @@ private:
     /// Called by ProcessIncoming() on CMSG_PING.
     int HandlePing(WorldPacket& recvPacket);
 
-    bool AppendPacket(const WorldPacket &pct);
+    bool AppendPacket(const WorldPacket &pct, const SharedWorldPacket* shared = nullptr);
 
     /// Time in which the last ping was received
     std::chrono::system_clock::time_point m_LastPingTime;
@@ -35,7 +35,9 @@ INSTANTIATE_CLASS_MUTEX(WorldSocketMgr, boost::recursive_mutex);
 WorldSocketMgr::WorldSocketMgr() : NetworkManager("World"),
     m_SockOutKBuff(-1),
     m_SockOutUBuff(protocol::SEND_BUFFER_SIZE),
-    m_UseNoDelay(true)
+    m_SockOutUBuffHardLimit(protocol::SEND_HARD_LIMIT),
+    m_UseNoDelay(true),
+    m_UseGatherSend(true)
 {
 }
 
@@ -49,6 +51,7 @@ bool WorldSocketMgr::StartNetwork(boost::uint16_t port, std::string address)
         return false;
 
     m_UseNoDelay = sConfig.GetBoolDefault("Network.TcpNodelay", true);
+    m_UseGatherSend = sConfig.GetBoolDefault("Network.GatherSend", true);
 
     // -1 means use default
     m_SockOutKBuff = sConfig.GetIntDefault("Network.OutKBuff", -1);
@@ -62,6 +65,15 @@ bool WorldSocketMgr::StartNetwork(boost::uint16_t port, std::string address)
         return false;
     }
 
+    m_SockOutUBuffHardLimit = sConfig.GetIntDefault("Network.OutUBuffHardLimit", protocol::SEND_HARD_LIMIT);
+
+    if (m_SockOutUBuffHardLimit < m_SockOutUBuff)
+    {
+        sLog.outError("Network.OutUBuffHardLimit is wrong in your config file, must be not less than Network.OutUBuff");
+
+        return false;
+    }
+
     network_threads_count_ = static_cast<size_t>(sConfig.GetIntDefault("Network.Threads", 1));
 
     if (!NetworkManager::StartNetwork(port, address))
@@ -88,7 +100,8 @@ bool WorldSocketMgr::OnSocketOpen(const SocketPtr& socket)
         return false;
     }
 
-    socket->SetOutgoingBufferSize(static_cast<size_t>(m_SockOutUBuff));
+    socket->SetOutgoingBufferLimits(static_cast<size_t>(m_SockOutUBuff), static_cast<size_t>(m_SockOutUBuffHardLimit));
+    socket->SetGatherSend(m_UseGatherSend);
 
     return NetworkManager::OnSocketOpen(socket);
 }
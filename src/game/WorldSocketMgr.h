@@ -50,7 +50,9 @@ private:
 
     int     m_SockOutKBuff;
     int     m_SockOutUBuff;
+    int     m_SockOutUBuffHardLimit;
     bool    m_UseNoDelay;
+    bool    m_UseGatherSend;
 };
 
 #define sWorldSocketMgr WorldSocketMgr::Instance()
@@ -36,6 +36,7 @@
 #include "MassMailMgr.h"
 #include "MaNGOSsoap.h"
 #include "MapManager.h"
+#include "PacketCapture.h"
 #include "ProgressBar.h"
 #include "RemoteAdministration.h"
 #include "revision.h"
@@ -101,14 +102,15 @@ bool StartDatabase()
     // Get world database info from configuration file
     std::string dbstring = sConfig.GetStringDefault("WorldDatabaseInfo", "");
     int nConnections = sConfig.GetIntDefault("WorldDatabaseConnections", 1);
+    int nAsyncConnections = sConfig.GetIntDefault("WorldDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Database not specified in configuration file");
         return false;
     }
-    sLog.outString("World Database total connections: %i", nConnections + 1);
+    sLog.outString("World Database total connections: %i", nConnections + nAsyncConnections);
     // Initialise the world database
-    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to world database %s", dbstring.c_str());
         return false;
@@ -121,6 +123,7 @@ bool StartDatabase()
     }
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("CharacterDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -128,9 +131,9 @@ bool StartDatabase()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i", nConnections + nAsyncConnections);
     // Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
         // Wait for already started DB delay threads to end
@@ -147,6 +150,7 @@ bool StartDatabase()
     // Get login database info from configuration file
     dbstring = sConfig.GetStringDefault("LoginDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("LoginDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Login database not specified in configuration file");
@@ -156,8 +160,8 @@ bool StartDatabase()
         return false;
     }
     // Initialise the login database
-    sLog.outString("Login Database total connections: %i", nConnections + 1);
-    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
+    sLog.outString("Login Database total connections: %i", nConnections + nAsyncConnections);
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to login database %s", dbstring.c_str());
         // Wait for already started DB delay threads to end
@@ -547,6 +551,8 @@ extern int main(int argc, char** argv)
 
     sWorldSocketMgr.StopNetwork();
 
+    sPacketCapture.Finish();
+
     RemoteAdminMgr->StopNetwork();
 
     MapManager::Instance().UnloadAll();                     // unload all grids (including locked in memory)
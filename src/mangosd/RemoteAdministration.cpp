@@ -230,15 +230,15 @@ bool RASocket::SendPacket(const char* buf, size_t len)
 {
     GuardType Guard(out_buffer_lock_);
 
-    if (out_buffer_->Write((uint8*)buf, len))
+    if (!CanQueueOutgoing(len))
     {
-        StartAsyncSend();
-        return true;
+        sLog.outError("network write buffer hard limit reached, client doesn't receive data");
+        return false;
     }
-    else
-        sLog.outError("network write buffer is too small to accommodate packet");
 
-    return false;
+    out_buffer_.Write((uint8*)buf, len);
+    StartAsyncSend();
+    return true;
 }
 
 size_t RASocket::ReceivedDataLength(void) const
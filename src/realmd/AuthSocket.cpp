@@ -23,12 +23,15 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 #include <openssl/md5.h>
+#include <boost/bind.hpp>
+#include <cstdarg>
 #include "AuthCodes.h"
 #include "AuthSocket.h"
 #include "Common.h"
 #include "Config/Config.h"
 #include "Database/DatabaseEnv.h"
 #include "Log.h"
+#include "Network/NetworkThread.h"
 #include "PatchHandler.h"
 #include "RealmList.h"
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -162,7 +165,18 @@ typedef struct AuthHandler
 #endif
 
 /// Constructor - set the N and g values for SRP6
-AuthSocket::AuthSocket(NetworkManager& manager, NetworkThread& owner) : Socket(manager, owner), authed_(false), build_(0)
+uint32 AuthSocket::s_wrongPassMaxCount = 0;
+uint32 AuthSocket::s_wrongPassBanTime = 600;
+bool AuthSocket::s_wrongPassBanType = false;
+
+void AuthSocket::LoadConfig()
+{
+    s_wrongPassMaxCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+    s_wrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+    s_wrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+}
+
+AuthSocket::AuthSocket(NetworkManager& manager, NetworkThread& owner) : Socket(manager, owner), authed_(false), query_pending_(false), build_(0)
 {
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
@@ -207,6 +221,10 @@ bool AuthSocket::ProcessIncomingData()
     uint8 _cmd;
     while (1)
     {
+        // rest of input is handled after the answer of the database
+        if (query_pending_)
+            return true;
+
         if (!read_buffer_->ReadNoConsume(&_cmd, 1))
             return true;
 
@@ -243,19 +261,15 @@ bool AuthSocket::SendPacket(const char* buf, size_t len)
 {
     GuardType Guard(out_buffer_lock_);
 
-    if (out_buffer_->Write((uint8*)buf, len))
+    if (!CanQueueOutgoing(len))
     {
-        StartAsyncSend();
-        return true;
+        sLog.outError("network write buffer hard limit reached, client doesn't receive data. Disconnecting client");
+        return false;
     }
-    else
-    {
-        // Enqueue the packet.
-        sLog.outError("network write buffer is too small to accommodate packet. Disconnecting client");
 
-        MANGOS_ASSERT(false);
-        return false;
-    }    
+    out_buffer_.Write((uint8*)buf, len);
+    StartAsyncSend();
+    return true;
 }
 
 size_t AuthSocket::ReceivedDataLength(void) const
@@ -273,6 +287,56 @@ void AuthSocket::ReadSkip(size_t len)
     read_buffer_->Consume(len);
 }
 
+/// Start query on LoginDatabase async connection, handler gets the result on network thread of the socket
+bool AuthSocket::AsyncQuery(QueryHandler handler, const char* format, ...)
+{
+    char sql[MAX_QUERY_LEN];
+
+    va_list ap;
+    va_start(ap, format);
+    int res = vsnprintf(sql, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return false;
+    }
+
+    query_pending_ = true;
+
+    if (!LoginDatabase.AsyncQuery(&AuthSocket::QueryCallback, shared_from_this(), handler, sql))
+    {
+        query_pending_ = false;
+        return false;
+    }
+
+    return true;
+}
+
+/// Called by LoginDatabase.ProcessResultQueue() in main thread, passes result to network thread of the socket
+void AuthSocket::QueryCallback(QueryResult* result, SocketPtr socket, QueryHandler handler)
+{
+    socket->owner().service().post(boost::bind(&AuthSocket::OnQueryResult, boost::static_pointer_cast<AuthSocket>(socket), result, handler));
+}
+
+void AuthSocket::OnQueryResult(QueryResult* result, QueryHandler handler)
+{
+    query_pending_ = false;
+
+    if (IsClosed())
+    {
+        delete result;
+        return;
+    }
+
+    (this->*handler)(result);
+
+    ///- Continue with input received while waiting
+    if (!ProcessIncomingData())
+        CloseSocket();
+}
+
 /// Logon Challenge command handler
 bool AuthSocket::HandleLogonChallenge()
 {
@@ -313,11 +377,13 @@ bool AuthSocket::HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     login_ = (const char*)ch->I;
     build_ = ch->build;
 
+    localization_name_.resize(4);
+    for (int i = 0; i < 4; ++i)
+        localization_name_[i] = ch->country[4 - i - 1];
+
     ///- Normalize account name
     // utf8ToUpperOnlyLatin(login_); -- client already send account in expected form
 
@@ -326,149 +392,164 @@ bool AuthSocket::HandleLogonChallenge()
     safe_login_ = login_;
     LoginDatabase.escape_string(safe_login_);
 
-    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
-    pkt << (uint8) 0x00;
-
     ///- Verify that this IP is not in the ip_banned table
     // No SQL injection possible (paste the IP address as passed by the socket)
     std::string address = GetRemoteAddress();
     LoginDatabase.escape_string(address);
-    QueryResult* result = LoginDatabase.PQuery("SELECT unbandate FROM ip_banned WHERE "
-                          //    permanent                    still banned
-                          "(unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str());
+    if (!AsyncQuery(&AuthSocket::HandleLogonChallengeIpBan, "SELECT unbandate FROM ip_banned WHERE "
+                    //    permanent                    still banned
+                    "(unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str()))
+    {
+        CloseSocket();
+        return false;
+    }
+
+    return true;
+}
+
+/// Logon Challenge continuation: IP ban check done
+void AuthSocket::HandleLogonChallengeIpBan(QueryResult* result)
+{
     if (result)
     {
-        pkt << (uint8)WOW_FAIL_BANNED;
+        ByteBuffer pkt;
+        pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+        pkt << (uint8) 0x00;
+        pkt << (uint8) WOW_FAIL_BANNED;
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", GetRemoteAddress().c_str());
         delete result;
+
+        SendPacket((char const*)pkt.contents(), pkt.size());
+        return;
     }
-    else
+
+    ///- Get the account details from the account table, with active account ban if any
+    // No SQL injection (escaped user name)
+    if (!AsyncQuery(&AuthSocket::HandleLogonChallengeAccount, "SELECT a.sha_pass_hash,a.id,a.locked,a.last_ip,a.gmlevel,a.v,a.s,b.bandate,b.unbandate FROM account a "
+                    "LEFT JOIN account_banned b ON b.id = a.id AND b.active = 1 AND (b.unbandate > UNIX_TIMESTAMP() OR b.unbandate = b.bandate) "
+                    "WHERE a.username = '%s'", safe_login_.c_str()))
+        CloseSocket();
+}
+
+/// Logon Challenge continuation: account data loaded, send challenge
+void AuthSocket::HandleLogonChallengeAccount(QueryResult* result)
+{
+    ByteBuffer pkt;
+    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+    pkt << (uint8) 0x00;
+
+    if (result)
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
+        ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+        bool locked = false;
+        if ((*result)[2].GetUInt8() == 1)                   // if ip is locked
+        {
+            DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", login_.c_str(), (*result)[3].GetString());
+            DEBUG_LOG("[AuthChallenge] Player address is '%s'", GetRemoteAddress().c_str());
+            if (strcmp((*result)[3].GetString(), GetRemoteAddress().c_str()))
+            {
+                DEBUG_LOG("[AuthChallenge] Account IP differs");
+                pkt << (uint8) WOW_FAIL_SUSPENDED;
+                locked = true;
+            }
+            else
+            {
+                DEBUG_LOG("[AuthChallenge] Account IP matches");
+            }
+        }
+        else
+        {
+            DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", login_.c_str());
+        }
 
-        result = LoginDatabase.PQuery("SELECT sha_pass_hash,id,locked,last_ip,gmlevel,v,s FROM account WHERE username = '%s'", safe_login_.c_str());
-        if (result)
+        if (!locked)
         {
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if ((*result)[2].GetUInt8() == 1)               // if ip is locked
+            ///- If the account is banned, reject the logon attempt
+            if (!(*result)[7].IsNULL())
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", login_.c_str(), (*result)[3].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", GetRemoteAddress().c_str());
-                if (strcmp((*result)[3].GetString(), GetRemoteAddress().c_str()))
+                if ((*result)[7].GetUInt64() == (*result)[8].GetUInt64())
                 {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << (uint8) WOW_FAIL_SUSPENDED;
-                    locked = true;
+                    pkt << (uint8) WOW_FAIL_BANNED;
+                    BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", login_.c_str());
                 }
                 else
                 {
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
+                    pkt << (uint8) WOW_FAIL_SUSPENDED;
+                    BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", login_.c_str());
                 }
             }
             else
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", login_.c_str());
-            }
+                ///- Get the password from the account table, upper it, and make the SRP6 calculation
+                std::string rI = (*result)[0].GetCppString();
 
-            if (!locked)
-            {
-                ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
-                                         "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)", (*result)[1].GetUInt32());
-                if (banresult)
-                {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << (uint8) WOW_FAIL_BANNED;
-                        BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", login_.c_str());
-                    }
-                    else
-                    {
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", login_.c_str());
-                    }
-
-                    delete banresult;
-                }
+                ///- Don't calculate (v, s) if there are already some in the database
+                std::string databaseV = (*result)[5].GetCppString();
+                std::string databaseS = (*result)[6].GetCppString();
+
+                DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+
+                // multiply with 2, bytes are stored as hexstring
+                if (databaseV.size() != s_BYTE_SIZE * 2 || databaseS.size() != s_BYTE_SIZE * 2)
+                    SetVSFields(rI);
                 else
                 {
-                    ///- Get the password from the account table, upper it, and make the SRP6 calculation
-                    std::string rI = (*result)[0].GetCppString();
+                    s.SetHexStr(databaseS.c_str());
+                    v.SetHexStr(databaseV.c_str());
+                }
 
-                    ///- Don't calculate (v, s) if there are already some in the database
-                    std::string databaseV = (*result)[5].GetCppString();
-                    std::string databaseS = (*result)[6].GetCppString();
+                BigNumber gmod = g.ModExp(b, N);
+                B = ((v * 3) + gmod) % N;
 
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+                MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
 
-                    // multiply with 2, bytes are stored as hexstring
-                    if (databaseV.size() != s_BYTE_SIZE * 2 || databaseS.size() != s_BYTE_SIZE * 2)
-                        SetVSFields(rI);
-                    else
-                    {
-                        s.SetHexStr(databaseS.c_str());
-                        v.SetHexStr(databaseV.c_str());
-                    }
+                BigNumber unk3;
+                unk3.SetRand(16 * 8);
 
-                    BigNumber gmod = g.ModExp(b, N);
-                    B = ((v * 3) + gmod) % N;
+                ///- Fill the response packet with the result
+                pkt << uint8(WOW_SUCCESS);
 
-                    MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
+                // B may be calculated < 32B so we force minimal length to 32B
+                pkt.append(B.AsByteArray(32), 32);          // 32 bytes
+                pkt << uint8(1);
+                pkt.append(g.AsByteArray(), 1);
+                pkt << uint8(32);
+                pkt.append(N.AsByteArray(32), 32);
+                pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
+                pkt.append(unk3.AsByteArray(16), 16);
+                uint8 securityFlags = 0;
+                pkt << uint8(securityFlags);                // security flags (0x0...0x04)
 
-                    BigNumber unk3;
-                    unk3.SetRand(16 * 8);
+                if (securityFlags & 0x01)                   // PIN input
+                {
+                    pkt << uint32(0);
+                    pkt << uint64(0) << uint64(0);          // 16 bytes hash?
+                }
 
-                    ///- Fill the response packet with the result
-                    pkt << uint8(WOW_SUCCESS);
+                if (securityFlags & 0x02)                   // Matrix input
+                {
+                    pkt << uint8(0);
+                    pkt << uint8(0);
+                    pkt << uint8(0);
+                    pkt << uint8(0);
+                    pkt << uint64(0);
+                }
 
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(B.AsByteArray(32), 32);      // 32 bytes
+                if (securityFlags & 0x04)                   // Security token input
                     pkt << uint8(1);
-                    pkt.append(g.AsByteArray(), 1);
-                    pkt << uint8(32);
-                    pkt.append(N.AsByteArray(32), 32);
-                    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-                    pkt.append(unk3.AsByteArray(16), 16);
-                    uint8 securityFlags = 0;
-                    pkt << uint8(securityFlags);            // security flags (0x0...0x04)
-
-                    if (securityFlags & 0x01)               // PIN input
-                    {
-                        pkt << uint32(0);
-                        pkt << uint64(0) << uint64(0);      // 16 bytes hash?
-                    }
-
-                    if (securityFlags & 0x02)               // Matrix input
-                    {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
-
-                    if (securityFlags & 0x04)               // Security token input
-                        pkt << uint8(1);
-
-                    uint8 secLevel = (*result)[4].GetUInt8();
-                    account_security_level_ = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
-
-                    localization_name_.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                        localization_name_[i] = ch->country[4 - i - 1];
-
-                    BASIC_LOG("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", login_.c_str(), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(localization_name_));
-                }
+
+                uint8 secLevel = (*result)[4].GetUInt8();
+                account_security_level_ = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+
+                BASIC_LOG("[AuthChallenge] account %s is using '%s' locale (%u)", login_.c_str(), localization_name_.c_str(), GetLocaleByName(localization_name_));
             }
-            delete result;
         }
-        else                                                // no account
-            pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+        delete result;
     }
+    else                                                    // no account
+        pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+
     SendPacket((char const*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Logon Proof command handler
@@ -659,47 +740,56 @@ bool AuthSocket::HandleLogonProof()
         }
         BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", login_.c_str());
 
-        uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
-        if (MaxWrongPassCount > 0)
+        if (s_wrongPassMaxCount > 0)
         {
             // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
             LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", safe_login_.c_str());
 
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", safe_login_.c_str()))
+            // queued after the update on the same async connection, so it sees the new value
+            if (!AsyncQuery(&AuthSocket::HandleLogonProofFailedLogins, "SELECT id, failed_logins FROM account WHERE username = '%s'", safe_login_.c_str()))
             {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
-
-                if (failed_logins >= MaxWrongPassCount)
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
-
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                            login_.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = GetRemoteAddress();
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                            current_ip.c_str(), WrongPassBanTime, login_.c_str(), failed_logins);
-                    }
-                }
-                delete loginfail;
+                CloseSocket();
+                return false;
             }
         }
     }
     return true;
 }
 
+/// Logon Proof continuation: ban account or IP after too many failed logins
+void AuthSocket::HandleLogonProofFailedLogins(QueryResult* result)
+{
+    if (!result)
+        return;
+
+    Field* fields = result->Fetch();
+    uint32 failed_logins = fields[1].GetUInt32();
+
+    if (failed_logins >= s_wrongPassMaxCount)
+    {
+        uint32 WrongPassBanTime = s_wrongPassBanTime;
+
+        if (s_wrongPassBanType)
+        {
+            uint32 acc_id = fields[0].GetUInt32();
+            LoginDatabase.PExecute("INSERT INTO account_banned VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                   acc_id, WrongPassBanTime);
+            BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                login_.c_str(), WrongPassBanTime, failed_logins);
+        }
+        else
+        {
+            std::string current_ip = GetRemoteAddress();
+            LoginDatabase.escape_string(current_ip);
+            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                                   current_ip.c_str(), WrongPassBanTime);
+            BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                current_ip.c_str(), WrongPassBanTime, login_.c_str(), failed_logins);
+        }
+    }
+    delete result;
+}
+
 /// Reconnect Challenge command handler
 bool AuthSocket::HandleReconnectChallenge()
 {
@@ -738,14 +828,24 @@ bool AuthSocket::HandleReconnectChallenge()
     EndianConvert(ch->build);
     build_ = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", safe_login_.c_str());
+    if (!AsyncQuery(&AuthSocket::HandleReconnectChallengeSessionKey, "SELECT sessionkey FROM account WHERE username = '%s'", safe_login_.c_str()))
+    {
+        CloseSocket();
+        return false;
+    }
+
+    return true;
+}
 
+/// Reconnect Challenge continuation: session key loaded
+void AuthSocket::HandleReconnectChallengeSessionKey(QueryResult* result)
+{
     // Stop if the account is not found
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", login_.c_str());
         CloseSocket();
-        return false;
+        return;
     }
 
     Field* fields = result->Fetch();
@@ -760,7 +860,6 @@ bool AuthSocket::HandleReconnectChallenge()
     pkt.append(reconnect_proof_.AsByteArray(16), 16);        // 16 bytes random
     pkt << (uint64) 0x00 << (uint64) 0x00;                  // 16 bytes zeros
     SendPacket((char const*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Reconnect Proof command handler
@@ -815,27 +914,41 @@ bool AuthSocket::HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
+    ///- Get the user id (else close the connection) and amount of characters on all realms in one query
     // No SQL injection (escaped user name)
+    if (!AsyncQuery(&AuthSocket::HandleRealmListCharacters, "SELECT a.id,rc.realmid,rc.numchars FROM account a "
+                    "LEFT JOIN realmcharacters rc ON rc.acctid = a.id WHERE a.username = '%s'", safe_login_.c_str()))
+    {
+        CloseSocket();
+        return false;
+    }
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT id,sha_pass_hash FROM account WHERE username = '%s'", safe_login_.c_str());
+    return true;
+}
+
+/// %Realm List continuation: character counts loaded, send realm list
+void AuthSocket::HandleRealmListCharacters(QueryResult* result)
+{
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", login_.c_str());
         CloseSocket();
-        return false;
+        return;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    std::string rI = (*result)[1].GetCppString();
+    RealmList::CharacterCounts characterCounts;
+    do
+    {
+        Field* fields = result->Fetch();
+        if (!fields[1].IsNULL())
+            characterCounts[fields[1].GetUInt32()] = fields[2].GetUInt8();
+    }
+    while (result->NextRow());
     delete result;
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
-
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+    ///- Take cached realm list for client build and fill in # of user characters in each realm
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    sRealmList.WriteRealmListPacket(pkt, build_, account_security_level_, characterCounts);
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -843,8 +956,6 @@ bool AuthSocket::HandleRealmList()
     hdr.append(pkt);
 
     SendPacket((char const*)hdr.contents(), hdr.size());
-
-    return true;
 }
 
 void AuthSocket::SendProof(Sha1Hash sha)
@@ -886,135 +997,6 @@ void AuthSocket::SendProof(Sha1Hash sha)
     }
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
-{
-    switch (build_)
-    {
-        case 5875:                                          // 1.12.1
-        case 6005:                                          // 1.12.2
-        case 6141:                                          // 1.12.3
-        {
-            pkt << uint32(0);                               // unused value
-            pkt << uint8(sRealmList.size());
-
-            for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
-            {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
-                bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), build_) != i->second.realmbuilds.end();
-
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build_) : NULL;
-                if (!buildInfo)
-                    buildInfo = &i->second.realmBuildInfo;
-
-                RealmFlags realmflags = i->second.realmflags;
-
-                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
-                std::string name = i->first;
-                if (realmflags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    char buf[20];
-                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
-                    name += buf;
-                }
-
-                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
-                if (!ok_build || (i->second.allowedSecurityLevel > account_security_level_))
-                    realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
-
-                pkt << uint32(i->second.icon);              // realm type
-                pkt << uint8(realmflags);                   // realmflags
-                pkt << name;                                // name
-                pkt << i->second.address;                   // address
-                pkt << float(i->second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
-                pkt << uint8(i->second.timezone);           // realm category
-                pkt << uint8(0x00);                         // unk, may be realm number/id?
-            }
-
-            pkt << uint16(0x0002);                          // unused value (why 2?)
-            break;
-        }
-
-        case 8606:                                          // 2.4.3
-        case 10505:                                         // 3.2.2a
-        case 11159:                                         // 3.3.0a
-        case 11403:                                         // 3.3.2
-        case 11723:                                         // 3.3.3a
-        case 12340:                                         // 3.3.5a
-        default:                                            // and later
-        {
-            pkt << uint32(0);                               // unused value
-            pkt << uint16(sRealmList.size());
-
-            for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
-            {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
-                bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), build_) != i->second.realmbuilds.end();
-
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build_) : NULL;
-                if (!buildInfo)
-                    buildInfo = &i->second.realmBuildInfo;
-
-                uint8 lock = (i->second.allowedSecurityLevel > account_security_level_) ? 1 : 0;
-
-                RealmFlags realmFlags = i->second.realmflags;
-
-                // Show offline state for unsupported client builds
-                if (!ok_build)
-                    realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE);
-
-                if (!buildInfo)
-                    realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD);
-
-                pkt << uint8(i->second.icon);               // realm type (this is second column in Cfg_Configs.dbc)
-                pkt << uint8(lock);                         // flags, if 0x01, then realm locked
-                pkt << uint8(realmFlags);                   // see enum RealmFlags
-                pkt << i->first;                            // name
-                pkt << i->second.address;                   // address
-                pkt << float(i->second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
-                pkt << uint8(i->second.timezone);           // realm category (Cfg_Categories.dbc)
-                pkt << uint8(0x2C);                         // unk, may be realm number/id?
-
-                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    pkt << uint8(buildInfo->major_version);
-                    pkt << uint8(buildInfo->minor_version);
-                    pkt << uint8(buildInfo->bugfix_version);
-                    pkt << uint16(build_);
-                }
-            }
-
-            pkt << uint16(0x0010);                          // unused value (why 10?)
-            break;
-        }
-    }
-}
-
 void AuthSocket::InitPatch()
 {
     PatchHandlerPtr handler(new PatchHandler(socket(), patch_));
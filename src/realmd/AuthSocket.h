@@ -34,6 +34,7 @@
 
 class NetworkManager;
 class NetworkThread;
+class QueryResult;
 
 /// Handles authentication service packets
 class AuthSocket : public Socket
@@ -44,6 +45,9 @@ public:
     AuthSocket(NetworkManager& manager, NetworkThread& owner);
     ~AuthSocket();
 
+    // reads the failed login settings, called once at startup
+    static void LoadConfig();
+
 protected:
     virtual bool Open() override;
     virtual bool ProcessIncomingData() override;
@@ -61,7 +65,20 @@ private:
     bool HandleReconnectProof();
     bool HandleRealmList();
     void SendProof(Sha1Hash sha);
-    void LoadRealmlist(ByteBuffer& pkt, uint32 acctid);
+
+    // Database access: queries run on LoginDatabase async connection, the handler is called on
+    // the network thread of the socket and must delete the result; no input is processed meanwhile
+    typedef void (AuthSocket::*QueryHandler)(QueryResult*);
+    bool AsyncQuery(QueryHandler handler, const char* format, ...) ATTR_PRINTF(3, 4);
+    static void QueryCallback(QueryResult* result, SocketPtr socket, QueryHandler handler);
+    void OnQueryResult(QueryResult* result, QueryHandler handler);
+
+    // Login process continuations
+    void HandleLogonChallengeIpBan(QueryResult* result);
+    void HandleLogonChallengeAccount(QueryResult* result);
+    void HandleLogonProofFailedLogins(QueryResult* result);
+    void HandleReconnectChallengeSessionKey(QueryResult* result);
+    void HandleRealmListCharacters(QueryResult* result);
 
     // Patch transfer handlers
     void InitPatch();
@@ -79,6 +96,7 @@ private:
     BigNumber reconnect_proof_;
 
     bool authed_;
+    bool query_pending_;
 
     std::string login_;
     std::string safe_login_;
@@ -91,6 +109,11 @@ private:
     std::string localization_name_;
 
     boost::filesystem::fstream patch_;
+
+    // failed login handling, see WrongPass.* in realmd.conf
+    static uint32 s_wrongPassMaxCount;
+    static uint32 s_wrongPassBanTime;
+    static bool s_wrongPassBanType;
 };
 #endif
 /// @}
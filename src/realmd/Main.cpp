@@ -249,6 +249,8 @@ extern int main(int argc, char** argv)
         return 1;
     }
 
+    AuthSocket::LoadConfig();
+
     ///- Get the list of realms for the server
     sRealmList.Initialize(sConfig.GetIntDefault("RealmsStateUpdateDelay", 20));
     if (sRealmList.size() == 0)
@@ -344,6 +346,12 @@ extern int main(int argc, char** argv)
         // dont move this outside the loop, the reactor will modify it
         boost::this_thread::sleep(boost::posix_time::milliseconds(10));
 
+        // hand finished async queries of auth sockets over to their network threads
+        LoginDatabase.ProcessResultQueue();
+
+        // reload realms here, network threads only read the cached realm list
+        sRealmList.UpdateIfNeed();
+
         if ((++loopCounter) == numLoops)
         {
             loopCounter = 0;
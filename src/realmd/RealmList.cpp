@@ -83,11 +83,11 @@ void RealmList::Initialize(uint32 update_interval)
     UpdateRealms(true);
 }
 
-void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realm_flags,
+void RealmList::UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realm_flags,
     uint8 timezone, AccountTypes allowed_security_level, float population, const std::string& builds)
 {
     ///- Create new if not exist or update existed
-    Realm& realm = realms_[name];
+    Realm& realm = realms[name];
 
     realm.m_ID       = ID;
     realm.icon       = icon;
@@ -132,13 +132,17 @@ void RealmList::UpdateIfNeed()
 
     next_update_time_ = time(NULL) + update_interval_;
 
-    // Clears Realm list
-    realms_.clear();
-
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
 }
 
+bool RealmList::IsSameRealm(Realm const& a, Realm const& b)
+{
+    return a.address == b.address && a.icon == b.icon && a.realmflags == b.realmflags && a.timezone == b.timezone &&
+        a.m_ID == b.m_ID && a.allowedSecurityLevel == b.allowedSecurityLevel && a.populationLevel == b.populationLevel &&
+        a.realmbuilds == b.realmbuilds;
+}
+
 void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
@@ -146,6 +150,8 @@ void RealmList::UpdateRealms(bool init)
     ////                                               0   1     2        3     4     5           6         7                     8           9
     QueryResult* result = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
+    RealmMap realms;
+
     ///- Circle through results and add them to the realm map
     if (result)
     {
@@ -164,7 +170,7 @@ void RealmList::UpdateRealms(bool init)
                 realmflags &= (REALM_FLAG_OFFLINE | REALM_FLAG_NEW_PLAYERS | REALM_FLAG_RECOMMENDED | REALM_FLAG_SPECIFYBUILD);
             }
 
-            UpdateRealm(
+            UpdateRealm(realms,
                 Id, name, fields[2].GetCppString(), fields[3].GetUInt32(),
                 fields[4].GetUInt8(), RealmFlags(realmflags), fields[6].GetUInt8(),
                 (allowedSecurityLevel <= SEC_ADMINISTRATOR ? AccountTypes(allowedSecurityLevel) : SEC_ADMINISTRATOR),
@@ -176,4 +182,147 @@ void RealmList::UpdateRealms(bool init)
         while (result->NextRow());
         delete result;
     }
+
+    ///- Keep cached realm list packets if nothing changed
+    bool changed = realms.size() != realms_.size();
+    for (RealmMap::const_iterator itr = realms.begin(), old = realms_.begin(); !changed && itr != realms.end(); ++itr, ++old)
+        changed = itr->first != old->first || !IsSameRealm(itr->second, old->second);
+
+    if (!changed)
+        return;
+
+    boost::lock_guard<boost::mutex> guard(packets_lock_);
+    realms_.swap(realms);
+    packets_.clear();
+}
+
+void RealmList::WriteRealmListPacket(ByteBuffer& pkt, uint16 build, AccountTypes security, CharacterCounts const& characterCounts)
+{
+    boost::lock_guard<boost::mutex> guard(packets_lock_);
+
+    uint32 key = (uint32(build) << 8) | uint32(security);
+    RealmListPacketMap::iterator itr = packets_.find(key);
+    if (itr == packets_.end())
+    {
+        itr = packets_.insert(RealmListPacketMap::value_type(key, RealmListPacket())).first;
+        BuildRealmListPacket(itr->second, build, security);
+    }
+
+    ///- Copy cached list and put account character counts over it
+    size_t start = pkt.wpos();
+    pkt.append(itr->second.data);
+
+    for (std::vector<std::pair<uint32, size_t> >::const_iterator pos = itr->second.characterCountPos.begin(); pos != itr->second.characterCountPos.end(); ++pos)
+    {
+        CharacterCounts::const_iterator count = characterCounts.find(pos->first);
+        if (count != characterCounts.end())
+            pkt.put<uint8>(start + pos->second, count->second);
+    }
+}
+
+void RealmList::BuildRealmListPacket(RealmListPacket& packet, uint16 build, AccountTypes security) const
+{
+    ByteBuffer& pkt = packet.data;
+
+    switch (build)
+    {
+        case 5875:                                          // 1.12.1
+        case 6005:                                          // 1.12.2
+        case 6141:                                          // 1.12.3
+        {
+            pkt << uint32(0);                               // unused value
+            pkt << uint8(realms_.size());
+
+            for (RealmMap::const_iterator i = realms_.begin(); i != realms_.end(); ++i)
+            {
+                bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), build) != i->second.realmbuilds.end();
+
+                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build) : NULL;
+                if (!buildInfo)
+                    buildInfo = &i->second.realmBuildInfo;
+
+                RealmFlags realmflags = i->second.realmflags;
+
+                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
+                std::string name = i->first;
+                if (realmflags & REALM_FLAG_SPECIFYBUILD)
+                {
+                    char buf[20];
+                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
+                    name += buf;
+                }
+
+                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
+                if (!ok_build || (i->second.allowedSecurityLevel > security))
+                    realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
+
+                pkt << uint32(i->second.icon);              // realm type
+                pkt << uint8(realmflags);                   // realmflags
+                pkt << name;                                // name
+                pkt << i->second.address;                   // address
+                pkt << float(i->second.populationLevel);
+                packet.characterCountPos.push_back(std::make_pair(i->second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // amount of characters, set per account
+                pkt << uint8(i->second.timezone);           // realm category
+                pkt << uint8(0x00);                         // unk, may be realm number/id?
+            }
+
+            pkt << uint16(0x0002);                          // unused value (why 2?)
+            break;
+        }
+
+        case 8606:                                          // 2.4.3
+        case 10505:                                         // 3.2.2a
+        case 11159:                                         // 3.3.0a
+        case 11403:                                         // 3.3.2
+        case 11723:                                         // 3.3.3a
+        case 12340:                                         // 3.3.5a
+        default:                                            // and later
+        {
+            pkt << uint32(0);                               // unused value
+            pkt << uint16(realms_.size());
+
+            for (RealmMap::const_iterator i = realms_.begin(); i != realms_.end(); ++i)
+            {
+                bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), build) != i->second.realmbuilds.end();
+
+                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build) : NULL;
+                if (!buildInfo)
+                    buildInfo = &i->second.realmBuildInfo;
+
+                uint8 lock = (i->second.allowedSecurityLevel > security) ? 1 : 0;
+
+                RealmFlags realmFlags = i->second.realmflags;
+
+                // Show offline state for unsupported client builds
+                if (!ok_build)
+                    realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE);
+
+                if (!buildInfo)
+                    realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD);
+
+                pkt << uint8(i->second.icon);               // realm type (this is second column in Cfg_Configs.dbc)
+                pkt << uint8(lock);                         // flags, if 0x01, then realm locked
+                pkt << uint8(realmFlags);                   // see enum RealmFlags
+                pkt << i->first;                            // name
+                pkt << i->second.address;                   // address
+                pkt << float(i->second.populationLevel);
+                packet.characterCountPos.push_back(std::make_pair(i->second.m_ID, pkt.wpos()));
+                pkt << uint8(0);                            // amount of characters, set per account
+                pkt << uint8(i->second.timezone);           // realm category (Cfg_Categories.dbc)
+                pkt << uint8(0x2C);                         // unk, may be realm number/id?
+
+                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
+                {
+                    pkt << uint8(buildInfo->major_version);
+                    pkt << uint8(buildInfo->minor_version);
+                    pkt << uint8(buildInfo->bugfix_version);
+                    pkt << uint16(build);
+                }
+            }
+
+            pkt << uint16(0x0010);                          // unused value (why 10?)
+            break;
+        }
+    }
 }
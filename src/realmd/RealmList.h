@@ -24,6 +24,8 @@
 #define REALMLIST_H
 
 #include "Common.h"
+#include "ByteBuffer.h"
+#include <boost/thread/mutex.hpp>
 
 struct RealmBuildInfo
 {
@@ -57,27 +59,48 @@ class RealmList
 {
 public:
     typedef std::map<std::string, Realm> RealmMap;
-    
+    /// realm id -> amount of characters of the account
+    typedef std::map<uint32, uint8> CharacterCounts;
+
     static RealmList& Instance();
     
     RealmList();
     ~RealmList() {}
 
     void Initialize(uint32 update_interval);
+    /// Reload realms from database if update interval passed, must be called from one thread only
     void UpdateIfNeed();
 
     RealmMap::const_iterator begin() const { return realms_.begin(); }
     RealmMap::const_iterator end() const { return realms_.end(); }
     uint32 size() const { return realms_.size(); }
 
+    /// Append realm list (without command header) for client build and account, may be called from any thread
+    void WriteRealmListPacket(ByteBuffer& pkt, uint16 build, AccountTypes security, CharacterCounts const& characterCounts);
+
 private:
+    /// Serialized realm list for one client build and account security level, without character counts
+    struct RealmListPacket
+    {
+        ByteBuffer data;
+        std::vector<std::pair<uint32, size_t> > characterCountPos;    // realm id, position of its character count in data
+    };
+
+    typedef std::map<uint32, RealmListPacket> RealmListPacketMap;   // key: build << 8 | security level
+
     void UpdateRealms(bool init);
-    void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realm_flags,
+    static void UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realm_flags,
         uint8 timezone, AccountTypes allowed_security_level, float population, const std::string& builds);
+    static bool IsSameRealm(Realm const& a, Realm const& b);
+    void BuildRealmListPacket(RealmListPacket& packet, uint16 build, AccountTypes security) const;
 
     // Internal map of realms
     RealmMap realms_;
 
+    // Cached serialized realm lists, dropped when realms change
+    boost::mutex packets_lock_;
+    RealmListPacketMap packets_;
+
     uint32 update_interval_;
     time_t next_update_time_;
 };
@@ -79,6 +79,7 @@
 
 #include "Errors.h"
 #include "LockedQueue.h"
+#include "MPSCQueue.h"
 #include "Threading.h"
 
 #include <boost/cstdint.hpp>
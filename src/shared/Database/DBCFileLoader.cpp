@@ -21,73 +21,177 @@
 #include <string.h>
 
 #include "DBCFileLoader.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+static const uint32 DBC_HEADER_SIZE = 20;                   // signature, record count, field count, record size, string size
+
+DBCFileMapping::~DBCFileMapping()
+{
+    delete m_region;
+}
+
+unsigned char* DBCFileMapping::GetData() const
+{
+    return static_cast<unsigned char*>(m_region->get_address());
+}
+
+size_t DBCFileMapping::GetSize() const
+{
+    return m_region->get_size();
+}
 
 DBCFileLoader::DBCFileLoader()
 {
     data = NULL;
+    stringTable = NULL;
     fieldsOffset = NULL;
+    mapping = NULL;
+    mappingUsed = false;
+    dataInPlace = false;
 }
 
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
-    uint32 header;
-    delete[] data;
-
-    FILE* f = fopen(filename, "rb");
-    if (!f)return false;
+    Unload();
 
-    if (fread(&header, 4, 1, f) != 1)                       // Number of records
+    // reading into a heap buffer only if the file can't be mapped
+    if (!MapFile(filename) && !ReadFile(filename))
         return false;
 
-    EndianConvert(header);
-    if (header != 0x43424457)
-        return false;                                       //'WDBC'
+    fieldsOffset = new uint32[fieldCount];
+    fieldsOffset[0] = 0;
+    for (uint32 i = 1; i < fieldCount; ++i)
+    {
+        fieldsOffset[i] = fieldsOffset[i - 1];
+        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
+            fieldsOffset[i] += 1;
+        else                                                // 4 byte fields (int32/float/strings)
+            fieldsOffset[i] += 4;
+    }
 
-    if (fread(&recordCount, 4, 1, f) != 1)                  // Number of records
-        return false;
+    return true;
+}
 
-    EndianConvert(recordCount);
+bool DBCFileLoader::ReadHeader(unsigned char const* header)
+{
+    uint32 values[5];
+    memcpy(values, header, sizeof(values));
+    for (int i = 0; i < 5; ++i)
+        EndianConvert(values[i]);
 
-    if (fread(&fieldCount, 4, 1, f) != 1)                   // Number of fields
-        return false;
+    if (values[0] != 0x43424457)
+        return false;                                       //'WDBC'
 
-    EndianConvert(fieldCount);
+    recordCount = values[1];                                // Number of records
+    fieldCount = values[2];                                 // Number of fields
+    recordSize = values[3];                                 // Size of a record
+    stringSize = values[4];                                 // String size
+    return true;
+}
 
-    if (fread(&recordSize, 4, 1, f) != 1)                   // Size of a record
+bool DBCFileLoader::MapFile(const char* filename)
+{
+    try
+    {
+        // private pages, code patching loaded entries must not write to the file
+        boost::interprocess::file_mapping file(filename, boost::interprocess::read_only);
+        mapping = new DBCFileMapping(new boost::interprocess::mapped_region(file, boost::interprocess::copy_on_write));
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
         return false;
+    }
 
-    EndianConvert(recordSize);
-
-    if (fread(&stringSize, 4, 1, f) != 1)                   // String size
+    if (mapping->GetSize() < DBC_HEADER_SIZE || !ReadHeader(mapping->GetData()) ||
+            mapping->GetSize() < DBC_HEADER_SIZE + uint64(recordSize) * recordCount + stringSize)
+    {
+        delete mapping;
+        mapping = NULL;
         return false;
+    }
 
-    EndianConvert(stringSize);
+    data = mapping->GetData() + DBC_HEADER_SIZE;
+    stringTable = data + recordSize * recordCount;
+    return true;
+}
 
-    fieldsOffset = new uint32[fieldCount];
-    fieldsOffset[0] = 0;
-    for (uint32 i = 1; i < fieldCount; ++i)
+bool DBCFileLoader::ReadFile(const char* filename)
+{
+    FILE* f = fopen(filename, "rb");
+    if (!f)
+        return false;
+
+    unsigned char header[DBC_HEADER_SIZE];
+    if (fread(header, DBC_HEADER_SIZE, 1, f) != 1 || !ReadHeader(header))
     {
-        fieldsOffset[i] = fieldsOffset[i - 1];
-        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
-            fieldsOffset[i] += 1;
-        else                                                // 4 byte fields (int32/float/strings)
-            fieldsOffset[i] += 4;
+        fclose(f);
+        return false;
     }
 
     data = new unsigned char[recordSize * recordCount + stringSize];
     stringTable = data + recordSize * recordCount;
 
     if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
+    {
+        fclose(f);
         return false;
+    }
 
     fclose(f);
     return true;
 }
 
-DBCFileLoader::~DBCFileLoader()
+void DBCFileLoader::Unload()
 {
-    delete[] data;
+    if (mapping)
+        delete mapping;
+    else
+        delete[] data;
+
     delete[] fieldsOffset;
+
+    data = NULL;
+    stringTable = NULL;
+    fieldsOffset = NULL;
+    mapping = NULL;
+    mappingUsed = false;
+    dataInPlace = false;
+}
+
+DBCFileLoader::~DBCFileLoader()
+{
+    Unload();
+}
+
+DBCFileMapping* DBCFileLoader::ReleaseMapping()
+{
+    if (!mapping || !mappingUsed)
+        return NULL;
+
+    DBCFileMapping* released = mapping;
+    mapping = NULL;
+    data = NULL;
+    stringTable = NULL;
+    return released;
+}
+
+bool DBCFileLoader::IsInPlaceFormat(const char* format) const
+{
+#if MANGOS_ENDIAN == MANGOS_BIGENDIAN
+    return false;                                           // values need conversion
+#else
+    // records must be aligned for the 4 byte fields of the entry structures
+    if (!mapping || recordSize % 4 != 0)
+        return false;
+
+    // every file field has to be in the structure with the same size, strings need a pointer
+    for (uint32 x = 0; format[x]; ++x)
+        if (format[x] != FT_INT && format[x] != FT_FLOAT && format[x] != FT_IND && format[x] != FT_BYTE)
+            return false;
+
+    return GetFormatRecordSize(format) == recordSize;
+#endif
 }
 
 DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
@@ -183,6 +287,22 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    if (IsInPlaceFormat(format))
+    {
+        for (uint32 y = 0; y < recordCount; ++y)
+        {
+            char* record = reinterpret_cast<char*>(data + y * recordSize);
+            if (i >= 0)
+                indexTable[getRecord(y).getUInt(i)] = record;
+            else
+                indexTable[y] = record;
+        }
+
+        mappingUsed = true;
+        dataInPlace = true;
+        return reinterpret_cast<char*>(data);
+    }
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -239,8 +359,19 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
     if (strlen(format) != fieldCount)
         return NULL;
 
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+    // strings of a mapped file stay where they are
+    char* stringPool;
+    if (mapping)
+    {
+        stringPool = reinterpret_cast<char*>(stringTable);
+        if (strchr(format, FT_STRING))
+            mappingUsed = true;
+    }
+    else
+    {
+        stringPool = new char[stringSize];
+        memcpy(stringPool, stringTable, stringSize);
+    }
 
     uint32 offset = 0;
 
@@ -286,5 +417,5 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
         }
     }
 
-    return stringPool;
+    return mapping ? NULL : stringPool;
 }
@@ -22,6 +22,8 @@
 #include "Utilities/ByteConverter.h"
 #include <cassert>
 
+namespace boost { namespace interprocess { class mapped_region; } }
+
 enum FieldFormat
 {
     FT_NA = 'x',                                            // ignore/ default, 4 byte size, in Source String means field is ignored, in Dest String means field is filled with default value
@@ -37,6 +39,23 @@ enum FieldFormat
     FT_LOGIC = 'l'                                          // Logical (boolean)
 };
 
+/// Memory mapped DBC file, kept alive by the storage as long as data or strings point into it
+class DBCFileMapping
+{
+    public:
+        explicit DBCFileMapping(boost::interprocess::mapped_region* region) : m_region(region) {}
+        ~DBCFileMapping();
+
+        unsigned char* GetData() const;
+        size_t GetSize() const;
+
+    private:
+        DBCFileMapping(DBCFileMapping const&);
+        DBCFileMapping& operator=(DBCFileMapping const&);
+
+        boost::interprocess::mapped_region* m_region;
+};
+
 class DBCFileLoader
 {
     public:
@@ -92,10 +111,22 @@ class DBCFileLoader
         uint32 GetCols() const { return fieldCount; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != NULL && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() {return (data != NULL);}
+        // returns the records of the mapped file itself when the format matches the file layout, see IsDataInPlace()
         char* AutoProduceData(const char* fmt, uint32& count, char**& indexTable);
+        // strings of a mapped file are used in place and NULL is returned, else a string pool to free by caller
         char* AutoProduceStrings(const char* fmt, char* dataTable);
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = NULL);
+
+        /// The data table returned by AutoProduceData points into the file mapping and must not be freed
+        bool IsDataInPlace() const { return dataInPlace; }
+        /// Pass ownership of the file mapping if produced data or strings point into it, else NULL
+        DBCFileMapping* ReleaseMapping();
     private:
+        bool MapFile(const char* filename);
+        bool ReadFile(const char* filename);
+        bool ReadHeader(unsigned char const* header);
+        bool IsInPlaceFormat(const char* format) const;
+        void Unload();
 
         uint32 recordSize;
         uint32 recordCount;
@@ -104,5 +135,9 @@ class DBCFileLoader
         uint32* fieldsOffset;
         unsigned char* data;
         unsigned char* stringTable;
+
+        DBCFileMapping* mapping;                            // data and stringTable point into it if not NULL
+        bool mappingUsed;                                   // produced data or strings point into mapping
+        bool dataInPlace;
 };
 #endif
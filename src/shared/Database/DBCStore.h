@@ -25,8 +25,9 @@ template<class T>
 class DBCStorage
 {
         typedef std::list<char*> StringPoolList;
+        typedef std::list<DBCFileMapping*> MappingList;
     public:
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(NULL), m_dataTable(NULL) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(NULL), m_dataTable(NULL), m_dataInPlace(false) { }
         ~DBCStorage() { Clear(); }
 
         T const* LookupEntry(uint32 id) const { return (id >= nCount) ? NULL : indexTable[id]; }
@@ -45,9 +46,10 @@ class DBCStorage
 
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
+            m_dataInPlace = dbc.IsDataInPlace();
 
             // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            AddStrings(dbc);
 
             // error in dbc file at loading if NULL
             return indexTable != NULL;
@@ -65,7 +67,7 @@ class DBCStorage
                 return false;
 
             // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            AddStrings(dbc);
 
             return true;
         }
@@ -77,14 +79,22 @@ class DBCStorage
 
             delete[]((char*)indexTable);
             indexTable = NULL;
-            delete[]((char*)m_dataTable);
+            if (!m_dataInPlace)
+                delete[]((char*)m_dataTable);
             m_dataTable = NULL;
+            m_dataInPlace = false;
 
             while (!m_stringPoolList.empty())
             {
                 delete[] m_stringPoolList.front();
                 m_stringPoolList.pop_front();
             }
+
+            while (!m_mappingList.empty())
+            {
+                delete m_mappingList.front();
+                m_mappingList.pop_front();
+            }
             nCount = 0;
         }
 
@@ -92,12 +102,24 @@ class DBCStorage
         void InsertEntry(T* entry, uint32 id) { assert(id < nCount && "To be inserted entry must be in bounds!"); indexTable[id] = entry; }
 
     private:
+        // strings of mapped files are used in place, the mapping is kept instead of a string pool
+        void AddStrings(DBCFileLoader& dbc)
+        {
+            if (char* stringPool = dbc.AutoProduceStrings(fmt, (char*)m_dataTable))
+                m_stringPoolList.push_back(stringPool);
+
+            if (DBCFileMapping* mapping = dbc.ReleaseMapping())
+                m_mappingList.push_back(mapping);
+        }
+
         uint32 nCount;
         uint32 fieldCount;
         char const* fmt;
         T** indexTable;
         T* m_dataTable;
+        bool m_dataInPlace;                                 // m_dataTable points into the first mapping
         StringPoolList m_stringPoolList;
+        MappingList m_mappingList;
 };
 
 #endif
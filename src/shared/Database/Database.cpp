@@ -86,8 +86,59 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     SqlPreparedStatement* pStmt = GetStmt(nIndex);
     // bind parameters
     pStmt->bind(id);
+
+    SqlMetrics& metrics = m_db.GetMetrics();
+    if (!metrics.IsEnabled())
+        return pStmt->execute();
+
+    // execute statement
+    uint64 start = SqlMetrics::GetTimeUs();
+    bool result = pStmt->execute();
+    metrics.AddStatement(nIndex, SqlMetrics::GetTimeUs() - start);
+    return result;
+}
+
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if (nIndex == -1)
+        return NULL;
+
+    // get prepared statement object
+    SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    // bind parameters
+    pStmt->bind(id);
+
+    SqlMetrics& metrics = m_db.GetMetrics();
+    if (!metrics.IsEnabled())
+        return pStmt->query();
+
     // execute statement
-    return pStmt->execute();
+    uint64 start = SqlMetrics::GetTimeUs();
+    QueryResult* result = pStmt->query();
+    metrics.AddStatement(nIndex, SqlMetrics::GetTimeUs() - start);
+    return result;
+}
+
+void SqlConnection::LockContended()
+{
+    SqlMetrics& metrics = m_db.GetMetrics();
+    if (!metrics.IsEnabled())
+    {
+        m_mutex.lock();
+        return;
+    }
+
+    uint64 start = SqlMetrics::GetTimeUs();
+    m_mutex.lock();
+    metrics.AddLockWait(SqlMetrics::GetTimeUs() - start);
+}
+
+QueryResult* SqlConnection::QueryStreamed(const char* sql)
+{
+    // no streaming support, fall back to a buffered result
+    QueryResult* result = Query(sql);
+    m_db.ReleaseStreamConnection(this);
+    return result;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -96,7 +147,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -109,6 +160,7 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     }
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
+    m_infoString = infoString;
 
     // create DB connections
 
@@ -133,10 +185,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConnections.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConnections[0];
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -149,41 +216,116 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
-
     m_pResultQueue = NULL;
+
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
+        delete m_pAsyncConnections[i];
+
+    m_pAsyncConnections.clear();
     m_pAsyncConn = NULL;
 
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
         delete m_pQueryConnections[i];
 
     m_pQueryConnections.clear();
+
+    // streamed results still alive at this point leak their connection
+    boost::lock_guard<boost::mutex> guard(m_streamLock);
+    for (size_t i = 0; i < m_pStreamConnections.size(); ++i)
+        delete m_pStreamConnections[i];
+
+    m_streamConnectionCount -= m_pStreamConnections.size();
+    m_pStreamConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    m_delayHalting = false;
+
+    // New delay thread for delay execute, one per async connection
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
+    {
+        // only the first thread pings, Ping() covers all connections
+        SqlDelayThread* threadBody = CreateDelayThread(m_pAsyncConnections[i], i == 0);
+        m_threadBodies.push_back(threadBody);               // will deleted at thread delete
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
+
+    m_queryPool.Activate(m_pQueryConnections);
+}
+
+uint32 Database::GetAsyncQueueSize() const
+{
+    uint32 size = 0;
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        size += m_threadBodies[i]->GetQueueSize();
+
+    return size;
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (m_threadBodies.empty() || m_delayThreads.empty()) return;
+
+    {
+        // barriers queued from now on could wait for an already finished thread
+        boost::lock_guard<boost::mutex> guard(m_delayLock);
+        m_delayHalting = true;
+    }
+
+    // stop all threads first so they flush to DB in parallel
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Stop();                          // Stop event
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+        delete m_delayThreads[i];                           // This also deletes thread body
+    }
+
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+
+    // after the delay threads, query holders queued to them still use the workers
+    m_queryPool.Deactivate();
+}
+
+bool Database::DelayOperation(SqlOperation* op)
+{
+    if (m_threadBodies.size() == 1)
+        return m_threadBodies[0]->Delay(op);
+
+    boost::lock_guard<boost::mutex> guard(m_delayLock);
+
+    SqlDelayThread* thread = GetDelayThread(op->GetSerialId());
+    if (op->GetSerialId() || m_delayHalting)
+    {
+        // requests queued at other connections from now on must not wait for the current barrier
+        if (thread != m_threadBodies[0])
+            m_delayBarrier.reset();
+
+        return thread->Delay(op);
+    }
+
+    // request without serial id must see the results of everything queued before and be
+    // seen by everything queued after it, at any of the async connections. While nothing
+    // was queued at the other connections since the last such request, it joins its barrier
+    if (!m_delayBarrier || !m_delayBarrier->AddRequest())
+    {
+        m_delayBarrier.reset(new SqlBarrier(m_threadBodies.size() - 1));
+        for (size_t i = 1; i < m_threadBodies.size(); ++i)
+            m_threadBodies[i]->Delay(new SqlBarrierWait(m_delayBarrier));
+    }
+
+    return m_threadBodies[0]->Delay(new SqlBarrierRequest(op, m_delayBarrier));
 }
 
 void Database::ThreadStart()
@@ -228,8 +370,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConnections[i]);
         delete guard->Query(sql);
     }
 
@@ -238,6 +381,47 @@ void Database::Ping()
         SqlConnection::Lock guard(m_pQueryConnections[i]);
         delete guard->Query(sql);
     }
+
+    // connections of alive streamed results are busy, only the idle ones need a ping
+    boost::lock_guard<boost::mutex> guard(m_streamLock);
+    for (size_t i = 0; i < m_pStreamConnections.size(); ++i)
+        delete m_pStreamConnections[i]->Query(sql);
+}
+
+SqlConnection* Database::getStreamConnection()
+{
+    {
+        boost::lock_guard<boost::mutex> guard(m_streamLock);
+        if (!m_pStreamConnections.empty())
+        {
+            SqlConnection* conn = m_pStreamConnections.back();
+            m_pStreamConnections.pop_back();
+            return conn;
+        }
+
+        if (m_streamConnectionCount >= MAX_STREAM_CONNECTIONS)
+            return NULL;
+
+        ++m_streamConnectionCount;
+    }
+
+    SqlConnection* conn = CreateConnection();
+    if (!conn->Initialize(m_infoString.c_str()))
+    {
+        delete conn;
+
+        boost::lock_guard<boost::mutex> guard(m_streamLock);
+        --m_streamConnectionCount;
+        return NULL;
+    }
+
+    return conn;
+}
+
+void Database::ReleaseStreamConnection(SqlConnection* conn)
+{
+    boost::lock_guard<boost::mutex> guard(m_streamLock);
+    m_pStreamConnections.push_back(conn);
 }
 
 bool Database::PExecuteLog(const char* format, ...)
@@ -303,6 +487,36 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::QueryStreamed(const char* sql)
+{
+    // all stream connections busy (or none can be opened): read the result at once
+    SqlConnection* conn = getStreamConnection();
+    if (!conn)
+        return Query(sql);
+
+    // the connection is released by the result
+    return conn->QueryStreamed(sql);
+}
+
+QueryResult* Database::PQueryStreamed(const char* format, ...)
+{
+    if (!format) return NULL;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return NULL;
+    }
+
+    return QueryStreamed(szQuery);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format) return NULL;
@@ -343,7 +557,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        DelayOperation(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -389,7 +603,7 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::BeginTransaction()
+bool Database::BeginTransaction(uint32 serialId /*= 0*/)
 {
     if (!m_pAsyncConn)
         return false;
@@ -399,7 +613,7 @@ bool Database::BeginTransaction()
 
     // initiate transaction on current thread
     // currently we do not support queued transactions
-    m_TransStorage->init();
+    m_TransStorage->init(serialId);
     return true;
 }
 
@@ -417,7 +631,7 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_TransStorage->detach());
+    DelayOperation(m_TransStorage->detach());
     return true;
 }
 
@@ -561,7 +775,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        DelayOperation(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -576,6 +790,15 @@ bool Database::DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* pa
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters* params)
+{
+    MANGOS_ASSERT(params);
+    std::auto_ptr<SqlStmtParameters> p(params);
+    // execute statement
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 {
     int nId = -1;
@@ -627,10 +850,11 @@ Database::TransHelper::~TransHelper()
     reset();
 }
 
-SqlTransaction* Database::TransHelper::init()
+SqlTransaction* Database::TransHelper::init(uint32 serialId)
 {
     MANGOS_ASSERT(!m_pTrans);   // if we will get a nested transaction request - we MUST fix code!!!
     m_pTrans = new SqlTransaction;
+    m_pTrans->SetSerialId(serialId);
     return m_pTrans;
 }
 
@@ -22,16 +22,21 @@
 #include "Threading.h"
 #include "Utilities/UnorderedMapSet.h"
 #include "Database/SqlDelayThread.h"
+#include "Database/SqlQueryPool.h"
+#include "Database/SqlMetrics.h"
 #include "Policies/ThreadingModel.h"
 
 #include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/lock_guard.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/tss.hpp>
 
 #include "SqlPreparedStatement.h"
 
+class SqlOperation;
 class SqlTransaction;
+class SqlBarrier;
 class SqlResultQueue;
 class SqlQueryHolder;
 class SqlStmtParameters;
@@ -66,12 +71,17 @@ class MANGOS_DLL_SPEC SqlConnection
 
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
 
         // SqlConnection object lock
         class Lock
         {
             public:
-                Lock(SqlConnection* conn) : m_pConn(conn) { m_pConn->m_mutex.lock(); }
+                Lock(SqlConnection* conn) : m_pConn(conn)
+                {
+                    if (!m_pConn->m_mutex.try_lock())
+                        m_pConn->LockContended();
+                }
                 ~Lock() { m_pConn->m_mutex.unlock(); }
 
                 SqlConnection* operator->() const { return m_pConn; }
@@ -80,6 +90,10 @@ class MANGOS_DLL_SPEC SqlConnection
                 SqlConnection* const m_pConn;
         };
 
+        // rows are read from the server while the result is iterated instead of being buffered at once,
+        // only called on a stream connection, the result returns it with Database::ReleaseStreamConnection
+        virtual QueryResult* QueryStreamed(const char* sql);
+
         // get DB object
         Database& DB() { return m_db; }
 
@@ -96,6 +110,9 @@ class MANGOS_DLL_SPEC SqlConnection
         void FreePreparedStatements();
 
     private:
+        // blocking lock of m_mutex held by another thread, the wait is recorded in the metrics
+        void LockContended();
+
         typedef boost::recursive_mutex LOCK_TYPE;
         LOCK_TYPE m_mutex;
 
@@ -108,10 +125,11 @@ class MANGOS_DLL_SPEC Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
+        // start worker threads for async DB request execution, one per async connection,
+        // and the query holder workers, one per query connection
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker threads
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
@@ -130,6 +148,15 @@ class MANGOS_DLL_SPEC Database
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
 
+        /// Streamed DB queries for big tables: memory use does not grow with the row count,
+        /// GetRowCount() of the result is 0 (unknown). Each streamed result owns a dedicated
+        /// connection until it is deleted, other queries can run while iterating it.
+        /// At most MAX_STREAM_CONNECTIONS are open, further concurrent streamed queries are read at once.
+        QueryResult* QueryStreamed(const char* sql);
+        QueryResult* PQueryStreamed(const char* format, ...) ATTR_PRINTF(2, 3);
+        // returns the connection of a finished streamed result to the stream connection pool
+        void ReleaseStreamConnection(SqlConnection* conn);
+
         inline bool DirectExecute(const char* sql)
         {
             if (!m_pAsyncConn)
@@ -181,13 +208,19 @@ class MANGOS_DLL_SPEC Database
         template<class Class, typename ParamType1>
         bool DelayQueryHolder(Class* object, void (Class::*method)(QueryResult*, SqlQueryHolder*, ParamType1), SqlQueryHolder* holder, ParamType1 param1);
 
+        // queue async request, the delay thread is selected by its serial id (see SqlOperation::SetSerialId)
+        bool DelayOperation(SqlOperation* op);
+
         bool Execute(const char* sql);
         bool PExecute(const char* format, ...) ATTR_PRINTF(2, 3);
 
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool BeginTransaction();
+        // transactions with equal serialId are committed in order by the same async connection,
+        // serialId 0 is ordered with all async requests of all connections, like plain async
+        // statements and queries without serial id
+        bool BeginTransaction(uint32 serialId = 0);
         bool CommitTransaction();
         bool RollbackTransaction();
         // for sync transaction execution
@@ -216,6 +249,15 @@ class MANGOS_DLL_SPEC Database
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() { return m_pingIntervallms; }
 
+        // number of async requests waiting for execution on all async connections
+        uint32 GetAsyncQueueSize() const;
+
+        // workers for parallel execution of query holders on the query connections
+        SqlQueryPool& GetQueryPool() { return m_queryPool; }
+
+        // statement latencies, lock waits and queue depth, collected only when enabled
+        SqlMetrics& GetMetrics() { return m_metrics; }
+
         // function to ping database connections
         void Ping();
 
@@ -226,8 +268,8 @@ class MANGOS_DLL_SPEC Database
 
     protected:
         Database() :
-            m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_pResultQueue(NULL),
-            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false),
+            m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_streamConnectionCount(0), m_pResultQueue(NULL),
+            m_delayHalting(false), m_queryPool(*this), m_metrics(*this), m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -238,7 +280,7 @@ class MANGOS_DLL_SPEC Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
 
         class MANGOS_DLL_SPEC TransHelper
         {
@@ -247,7 +289,7 @@ class MANGOS_DLL_SPEC Database
                 ~TransHelper();
 
                 // initializes new SqlTransaction object
-                SqlTransaction* init();
+                SqlTransaction* init(uint32 serialId);
                 // gets pointer on current transaction object. Returns NULL if transaction was not initiated
                 SqlTransaction* get() const { return m_pTrans; }
                 // detaches SqlTransaction object allocated by init() function
@@ -268,14 +310,20 @@ class MANGOS_DLL_SPEC Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // connection for direct (not queued) requests, also used by the first delay thread
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // idle stream connection, a new one is opened when all are in use
+        SqlConnection* getStreamConnection();
+        // delay thread executing the async requests with given serial id
+        SqlDelayThread* GetDelayThread(uint32 serialId) const { return m_threadBodies[serialId % m_threadBodies.size()]; }
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
+        // sync query on one of the query connections
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
@@ -285,12 +333,28 @@ class MANGOS_DLL_SPEC Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
-        SqlConnection* m_pAsyncConn;
+        // pool of connections for async requests and transactions, each one driven by its own delay thread
+        SqlConnectionContainer m_pAsyncConnections;
+        SqlConnection* m_pAsyncConn;                        ///< first async connection, used for direct execution
+
+        // idle connections for streamed queries, a streamed result holds its connection until deleted
+        enum { MAX_STREAM_CONNECTIONS = 2 };                ///< more concurrent streamed queries are buffered
+        SqlConnectionContainer m_pStreamConnections;
+        size_t m_streamConnectionCount;                     ///< opened stream connections, idle or busy
+        boost::mutex m_streamLock;                          ///< guards m_pStreamConnections and m_streamConnectionCount
+        std::string m_infoString;                           ///< connection info for opening stream connections
+
+        typedef std::vector<SqlDelayThread*> DelayThreadBodies;
+        typedef std::vector<MaNGOS::Thread*> DelayThreads;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread* m_delayThread;                      ///< Pointer to executer thread
+        DelayThreadBodies   m_threadBodies;                 ///< Delay sql executers, one per async connection (owned by m_delayThreads)
+        DelayThreads        m_delayThreads;                 ///< Executer threads
+        boost::mutex        m_delayLock;                    ///< keeps barriers in the same order in all delay queues
+        boost::shared_ptr<SqlBarrier> m_delayBarrier;       ///< barrier of the last request without serial id
+        bool                m_delayHalting;                 ///< no new barriers, delay threads are stopping
+        SqlQueryPool        m_queryPool;                    ///< Executes queries of query holders on m_pQueryConnections
+        SqlMetrics          m_metrics;                      ///< Operation metrics of all connections
 
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
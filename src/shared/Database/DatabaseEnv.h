@@ -46,6 +46,8 @@ typedef DatabaseMysql DatabaseType;
 #define _OFFSET_         "LIMIT %d,1"
 #endif
 
+#include "Database/SqlBatchInsert.h"
+
 extern DatabaseType WorldDatabase;
 extern DatabaseType CharacterDatabase;
 extern DatabaseType LoginDatabase;
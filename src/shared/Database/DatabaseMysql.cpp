@@ -172,6 +172,8 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     if (!mMysql)
         return 0;
 
+    SqlMetrics& metrics = m_db.GetMetrics();
+    uint64 metricsStart = metrics.IsEnabled() ? SqlMetrics::GetTimeUs() : 0;
     uint32 _s = WorldTimer::getMSTime();
 
     if (mysql_query(mMysql, sql))
@@ -189,6 +191,9 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     *pRowCount = mysql_affected_rows(mMysql);
     *pFieldCount = mysql_field_count(mMysql);
 
+    if (metricsStart)
+        metrics.AddQuery(sql, SqlMetrics::GetTimeUs() - metricsStart);
+
     if (!*pResult)
         return false;
 
@@ -238,12 +243,61 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+QueryResult* MySQLConnection::QueryStreamed(const char* sql)
+{
+    if (!mMysql)
+    {
+        m_db.ReleaseStreamConnection(this);
+        return NULL;
+    }
+
+    SqlMetrics& metrics = m_db.GetMetrics();
+    uint64 metricsStart = metrics.IsEnabled() ? SqlMetrics::GetTimeUs() : 0;
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_query(mMysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        m_db.ReleaseStreamConnection(this);
+        return NULL;
+    }
+    else
+    {
+        DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+    }
+
+    // rows are not read yet, only the server side execution is measured
+    if (metricsStart)
+        metrics.AddQuery(sql, SqlMetrics::GetTimeUs() - metricsStart);
+
+    MYSQL_RES* result = mysql_use_result(mMysql);
+    if (!result)
+    {
+        m_db.ReleaseStreamConnection(this);
+        return NULL;
+    }
+
+    QueryResultMysqlStreamed* queryResult = new QueryResultMysqlStreamed(result, mysql_fetch_fields(result), mysql_num_fields(result), this);
+
+    // row count is not known before reading, empty results are reported as NULL like buffered ones
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return NULL;
+    }
+
+    return queryResult;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!mMysql)
         return false;
 
     {
+        SqlMetrics& metrics = m_db.GetMetrics();
+        uint64 metricsStart = metrics.IsEnabled() ? SqlMetrics::GetTimeUs() : 0;
         uint32 _s = WorldTimer::getMSTime();
 
         if (mysql_query(mMysql, sql))
@@ -256,6 +310,9 @@ bool MySQLConnection::Execute(const char* sql)
         {
             DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
         }
+
+        if (metricsStart)
+            metrics.AddQuery(sql, SqlMetrics::GetTimeUs() - metricsStart);
         // end guarded block
     }
 
@@ -370,6 +427,7 @@ bool MySqlPreparedStatement::prepare()
         m_nColumns = mysql_num_fields(m_pResultMetadata);
 
         // bind output buffers
+        BindResult();
     }
 
     m_bPrepared = true;
@@ -439,6 +497,8 @@ void MySqlPreparedStatement::RemoveBinds()
     delete[] m_pInputArgs;
     delete[] m_pResult;
 
+    m_columns.clear();
+
     mysql_free_result(m_pResultMetadata);
     mysql_stmt_close(m_stmt);
 
@@ -465,6 +525,144 @@ bool MySqlPreparedStatement::execute()
     return true;
 }
 
+QueryResult* MySqlPreparedStatement::query()
+{
+    if (!isPrepared() || !isQuery())
+        return NULL;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_stmt_execute(m_stmt) || mysql_stmt_store_result(m_stmt))
+    {
+        sLog.outErrorDb("SQL: cannot execute '%s'", m_szFmt.c_str());
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(m_stmt));
+        return NULL;
+    }
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), m_szFmt.c_str());
+
+    uint64 rowCount = mysql_stmt_num_rows(m_stmt);
+    if (!rowCount)
+    {
+        mysql_stmt_free_result(m_stmt);
+        return NULL;
+    }
+
+    QueryResultMysqlStmt* queryResult = new QueryResultMysqlStmt(mysql_fetch_fields(m_pResultMetadata), rowCount, m_nColumns);
+
+    uint64 fetched = 0;
+    for (;;)
+    {
+        int res = mysql_stmt_fetch(m_stmt);
+        if (res == MYSQL_DATA_TRUNCATED)
+        {
+            // row is reported as not fetched below
+            if (!FetchTruncatedColumns())
+                break;
+        }
+        else if (res != 0)
+            break;
+
+        queryResult->AddRow(m_pResult);
+        ++fetched;
+    }
+
+    mysql_stmt_free_result(m_stmt);
+
+    if (fetched != rowCount)
+    {
+        sLog.outErrorDb("SQL: fetched " UI64FMTD " of " UI64FMTD " rows for '%s'", fetched, rowCount, m_szFmt.c_str());
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(m_stmt));
+        delete queryResult;
+        return NULL;
+    }
+
+    queryResult->NextRow();
+    return queryResult;
+}
+
+void MySqlPreparedStatement::BindResult()
+{
+    MYSQL_FIELD* fields = mysql_fetch_fields(m_pResultMetadata);
+
+    m_columns.resize(m_nColumns);
+    m_pResult = new MYSQL_BIND[m_nColumns];
+    memset(m_pResult, 0, sizeof(MYSQL_BIND) * m_nColumns);
+
+    for (uint32 i = 0; i < m_nColumns; ++i)
+    {
+        ResultColumn& column = m_columns[i];
+        MYSQL_BIND& bind = m_pResult[i];
+
+        // let the client library convert numbers to 64 bit integers and doubles,
+        // everything else (strings, dates, blobs, DECIMAL to keep its exact value) is fetched as text
+        switch (QueryResultMysql::IsDecimal(fields[i].type) ? Field::DB_TYPE_STRING : QueryResultMysql::ConvertNativeType(fields[i].type))
+        {
+            case Field::DB_TYPE_INTEGER:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = &column.number.integer;
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) ? 1 : 0;
+                break;
+            case Field::DB_TYPE_FLOAT:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &column.number.real;
+                break;
+            default:
+                // grows in FetchTruncatedColumns() if needed
+                column.text.resize(std::min<unsigned long>(fields[i].length, 255) + 1);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &column.text[0];
+                bind.buffer_length = column.text.size();
+                break;
+        }
+
+        bind.length = &column.length;
+        bind.is_null = &column.isNull;
+        bind.error = &column.error;
+    }
+
+    if (mysql_stmt_bind_result(m_stmt, m_pResult))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed for '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+    }
+}
+
+bool MySqlPreparedStatement::FetchTruncatedColumns()
+{
+    bool result = true;
+
+    for (uint32 i = 0; i < m_nColumns; ++i)
+    {
+        ResultColumn& column = m_columns[i];
+        if (!column.error || m_pResult[i].buffer_type != MYSQL_TYPE_STRING)
+            continue;
+
+        // buffers keep their size for the next executions of the statement
+        column.text.resize(column.length + 1);
+        m_pResult[i].buffer = &column.text[0];
+        m_pResult[i].buffer_length = column.text.size();
+        column.error = 0;
+
+        if (mysql_stmt_fetch_column(m_stmt, &m_pResult[i], i, 0))
+        {
+            sLog.outError("SQL ERROR: mysql_stmt_fetch_column() failed for column %u of '%s'", i, m_szFmt.c_str());
+            sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+            result = false;
+        }
+    }
+
+    // buffer addresses changed, must be bound again even if a column failed
+    if (mysql_stmt_bind_result(m_stmt, m_pResult))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed for '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        result = false;
+    }
+
+    return result;
+}
+
 enum_field_types MySqlPreparedStatement::ToMySQLType(const SqlStmtFieldData& data, my_bool& bUnsigned)
 {
     bUnsigned = 0;
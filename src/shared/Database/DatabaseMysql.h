@@ -48,6 +48,8 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
 
         // execute DML statement
         virtual bool execute() override;
+        // execute query, rows are fetched into binary bound buffers (no text conversion of numbers)
+        virtual QueryResult* query() override;
 
     protected:
         // bind parameters
@@ -57,12 +59,51 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
 
     private:
         void RemoveBinds();
+        // setup output buffers for the columns of a query statement
+        void BindResult();
+        // refetch string columns which did not fit into their output buffers, false if the row is lost
+        bool FetchTruncatedColumns();
+
+        // output buffer of one result column
+        struct ResultColumn
+        {
+            ResultColumn() : length(0), isNull(0), error(0) { number.integer = 0; }
+
+            union
+            {
+                uint64 integer;
+                double real;
+            } number;
+            std::vector<char> text;
+            unsigned long length;
+            my_bool isNull;
+            my_bool error;
+        };
+
+        typedef std::vector<ResultColumn> ResultColumns;
 
         MYSQL* m_pMySQLConn;
         MYSQL_STMT* m_stmt;
         MYSQL_BIND* m_pInputArgs;
         MYSQL_BIND* m_pResult;
         MYSQL_RES* m_pResultMetadata;
+        ResultColumns m_columns;
+};
+
+/// Result of a streamed query (mysql_use_result). Rows are read from the server while
+/// iterating, the stream connection is released when all rows are read or the result is deleted.
+class QueryResultMysqlStreamed : public QueryResultMysql
+{
+    public:
+        QueryResultMysqlStreamed(MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount, SqlConnection* conn);
+
+        ~QueryResultMysqlStreamed();
+
+    protected:
+        void EndQuery() override;
+
+    private:
+        SqlConnection* mConn;
 };
 
 class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
@@ -77,6 +118,7 @@ class MANGOS_DLL_SPEC MySQLConnection : public SqlConnection
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        QueryResult* QueryStreamed(const char* sql) override;
         bool Execute(const char* sql) override;
 
         unsigned long escape_string(char* to, const char* from, unsigned long length);
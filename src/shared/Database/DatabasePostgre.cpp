@@ -101,6 +101,8 @@ bool PostgreSQLConnection::_Query(const char* sql, PGresult** pResult, uint64* p
     if (!mPGconn)
         return false;
 
+    SqlMetrics& metrics = m_db.GetMetrics();
+    uint64 metricsStart = metrics.IsEnabled() ? SqlMetrics::GetTimeUs() : 0;
     uint32 _s = WorldTimer::getMSTime();
     // Send the query
     *pResult = PQexec(mPGconn, sql);
@@ -121,6 +123,9 @@ bool PostgreSQLConnection::_Query(const char* sql, PGresult** pResult, uint64* p
 
     *pRowCount = PQntuples(*pResult);
     *pFieldCount = PQnfields(*pResult);
+
+    if (metricsStart)
+        metrics.AddQuery(sql, SqlMetrics::GetTimeUs() - metricsStart);
     // end guarded block
 
     if (!*pRowCount)
@@ -177,6 +182,8 @@ bool PostgreSQLConnection::Execute(const char* sql)
     if (!mPGconn)
         return false;
 
+    SqlMetrics& metrics = m_db.GetMetrics();
+    uint64 metricsStart = metrics.IsEnabled() ? SqlMetrics::GetTimeUs() : 0;
     uint32 _s = WorldTimer::getMSTime();
 
     PGresult* res = PQexec(mPGconn, sql);
@@ -191,6 +198,9 @@ bool PostgreSQLConnection::Execute(const char* sql)
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
     }
 
+    if (metricsStart)
+        metrics.AddQuery(sql, SqlMetrics::GetTimeUs() - metricsStart);
+
     PQclear(res);
     return true;
 }
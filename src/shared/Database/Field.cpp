@@ -17,4 +17,49 @@
  */
 
 //#include "DatabaseEnv.h"
+#include "Field.h"
+
+#if COMPILER == COMPILER_MICROSOFT
+#  define strtoll _strtoi64
+#  define strtoull _strtoui64
+#endif
+
+void Field::SetValueAndConvert(const char* value)
+{
+    mValue = value;
+    mIsNumber = false;
+    mTextPending = false;
+
+    if (!value)
+        return;
+
+    switch (mType)
+    {
+        case DB_TYPE_INTEGER:
+            // negative values as two's complement, same as the old atol based getters returned
+            mNumber.integer = *value == '-' ? static_cast<uint64>(strtoll(value, NULL, 10)) : static_cast<uint64>(strtoull(value, NULL, 10));
+            mIsNumber = true;
+            break;
+        case DB_TYPE_FLOAT:
+            mNumber.real = strtod(value, NULL);
+            mIsNumber = true;
+            break;
+        default:
+            break;
+    }
+}
+
+const char* Field::NumberToString() const
+{
+    // buffer is writable, SetInteger()/SetReal() got it as char*
+    char* text = const_cast<char*>(mValue);
+    // enough digits to read back the same value: 9 for float, 17 for double
+    if (mType == DB_TYPE_FLOAT)
+        snprintf(text, NUMBER_TEXT_SIZE, mSinglePrecision ? "%.9g" : "%.17g", mNumber.real);
+    else
+        snprintf(text, NUMBER_TEXT_SIZE, SI64FMTD, static_cast<long long>(mNumber.integer));
+
+    mTextPending = false;
+    return text;
+}
 
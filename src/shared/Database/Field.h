@@ -34,28 +34,41 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        // size of the buffer given to SetInteger()/SetReal(), fits any formatted int64 or double
+        static const size_t NUMBER_TEXT_SIZE = 32;
+
+        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN), mIsNumber(false), mTextPending(false), mSinglePrecision(false) { mNumber.integer = 0; }
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mIsNumber(false), mTextPending(false), mSinglePrecision(false) { mNumber.integer = 0; }
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
-        bool IsNULL() const { return mValue == NULL; }
+        bool IsNULL() const { return !mIsNumber && mValue == NULL; }
 
-        const char* GetString() const { return mValue; }
+        const char* GetString() const { return mTextPending ? NumberToString() : mValue; }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mIsNumber)
+                return mType == DB_TYPE_FLOAT ? static_cast<float>(mNumber.real) : static_cast<float>(int64(mNumber.integer));
+
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        bool GetBool() const { return mIsNumber ? GetNumber() > 0 : (mValue ? atoi(mValue) > 0 : false); }
+        int32 GetInt32() const { return mIsNumber ? static_cast<int32>(GetNumber()) : (mValue ? static_cast<int32>(atol(mValue)) : int32(0)); }
+        uint8 GetUInt8() const { return mIsNumber ? static_cast<uint8>(GetNumber()) : (mValue ? static_cast<uint8>(atol(mValue)) : uint8(0)); }
+        uint16 GetUInt16() const { return mIsNumber ? static_cast<uint16>(GetNumber()) : (mValue ? static_cast<uint16>(atol(mValue)) : uint16(0)); }
+        int16 GetInt16() const { return mIsNumber ? static_cast<int16>(GetNumber()) : (mValue ? static_cast<int16>(atol(mValue)) : int16(0)); }
+        uint32 GetUInt32() const { return mIsNumber ? static_cast<uint32>(GetNumber()) : (mValue ? static_cast<uint32>(atol(mValue)) : uint32(0)); }
         uint64 GetUInt64() const
         {
+            if (mIsNumber)
+                return mType == DB_TYPE_FLOAT ? static_cast<uint64>(mNumber.real) : mNumber.integer;
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -66,13 +79,34 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; };
+        void SetValue(const char* value) { mValue = value; mIsNumber = false; mTextPending = false; }
+        // text value of a numeric column is parsed once here instead of in every getter call,
+        // the text is kept for GetString()
+        void SetValueAndConvert(const char* value);
+        // binary bound values (prepared statement results), getters do not parse text
+        // integers are stored as their 64 bit two's complement, signedness does not matter for the casts above
+        // text is written to textBuffer (NUMBER_TEXT_SIZE bytes, owned by the result) only if GetString() is called
+        void SetInteger(uint64 value, char* textBuffer) { mValue = textBuffer; mNumber.integer = value; mIsNumber = true; mTextPending = true; }
+        // singlePrecision: value was read from a FLOAT column, text gets only the digits a float holds
+        void SetReal(double value, char* textBuffer, bool singlePrecision) { mValue = textBuffer; mNumber.real = value; mIsNumber = true; mTextPending = true; mSinglePrecision = singlePrecision; }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        int64 GetNumber() const { return mType == DB_TYPE_FLOAT ? static_cast<int64>(mNumber.real) : static_cast<int64>(mNumber.integer); }
+        // formats binary value into the buffer given with it, only for code reading numeric columns as strings
+        const char* NumberToString() const;
+
         const char* mValue;
         enum DataTypes mType;
+        bool mIsNumber;
+        mutable bool mTextPending;                          // mValue points to a buffer not yet filled by NumberToString()
+        bool mSinglePrecision;                              // real came from a FLOAT column
+        union
+        {
+            uint64 integer;
+            double real;
+        } mNumber;
 };
 #endif
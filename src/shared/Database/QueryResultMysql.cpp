@@ -51,7 +51,7 @@ bool QueryResultMysql::NextRow()
     }
 
     for (uint32 i = 0; i < mFieldCount; ++i)
-        mCurrentRow[i].SetValue(row[i]);
+        mCurrentRow[i].SetValueAndConvert(row[i]);
 
     return true;
 }
@@ -68,7 +68,29 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+QueryResultMysqlStreamed::QueryResultMysqlStreamed(MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount, SqlConnection* conn) :
+    QueryResultMysql(result, fields, 0, fieldCount), mConn(conn)
+{
+}
+
+QueryResultMysqlStreamed::~QueryResultMysqlStreamed()
+{
+    EndQuery();
+}
+
+void QueryResultMysqlStreamed::EndQuery()
+{
+    // mysql_free_result reads the remaining rows, the connection is usable again after it
+    QueryResultMysql::EndQuery();
+
+    if (mConn)
+    {
+        mConn->DB().ReleaseStreamConnection(mConn);
+        mConn = NULL;
+    }
+}
+
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -90,7 +112,10 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
         case FIELD_TYPE_LONGLONG:
         case FIELD_TYPE_ENUM:
             return Field::DB_TYPE_INTEGER;
+        // DECIMAL columns are reported as NEWDECIMAL by MySQL 5.0+, both are converted once to double,
+        // prepared statements fetch them as text to keep the exact value for GetString()
         case FIELD_TYPE_DECIMAL:
+        case FIELD_TYPE_NEWDECIMAL:
         case FIELD_TYPE_FLOAT:
         case FIELD_TYPE_DOUBLE:
             return Field::DB_TYPE_FLOAT;
@@ -98,4 +123,103 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+QueryResultMysqlStmt::QueryResultMysqlStmt(MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mNextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    mNativeTypes.resize(mFieldCount);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+        mNativeTypes[i] = fields[i].type;
+    }
+
+    mValues.reserve(size_t(rowCount) * mFieldCount);
+    mNumberText.resize(mFieldCount * Field::NUMBER_TEXT_SIZE);
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    EndQuery();
+}
+
+void QueryResultMysqlStmt::AddRow(const MYSQL_BIND* binds)
+{
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        const MYSQL_BIND& bind = binds[i];
+
+        Value value;
+        value.integer = 0;
+        value.isNull = *bind.is_null != 0;
+
+        if (!value.isNull)
+        {
+            switch (bind.buffer_type)
+            {
+                case MYSQL_TYPE_LONGLONG:
+                    value.integer = *static_cast<const uint64*>(bind.buffer);
+                    break;
+                case MYSQL_TYPE_DOUBLE:
+                    value.real = *static_cast<const double*>(bind.buffer);
+                    break;
+                default:
+                {
+                    value.text = mText.size();
+                    const char* str = static_cast<const char*>(bind.buffer);
+                    mText.insert(mText.end(), str, str + *bind.length);
+                    mText.push_back('\0');
+                    break;
+                }
+            }
+        }
+
+        mValues.push_back(value);
+    }
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (!mCurrentRow)
+        return false;
+
+    if (mNextRow >= mRowCount)
+    {
+        EndQuery();
+        return false;
+    }
+
+    const Value* row = &mValues[size_t(mNextRow++) * mFieldCount];
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Field& field = mCurrentRow[i];
+
+        if (row[i].isNull)
+            field.SetValue(NULL);
+        else if (field.GetType() == Field::DB_TYPE_INTEGER)
+            field.SetInteger(row[i].integer, &mNumberText[i * Field::NUMBER_TEXT_SIZE]);
+        else if (QueryResultMysql::IsDecimal(mNativeTypes[i]))
+            field.SetValueAndConvert(&mText[row[i].text]);
+        else if (field.GetType() == Field::DB_TYPE_FLOAT)
+            field.SetReal(row[i].real, &mNumberText[i * Field::NUMBER_TEXT_SIZE], mNativeTypes[i] == FIELD_TYPE_FLOAT);
+        else
+            field.SetValue(&mText[row[i].text]);
+    }
+
+    return true;
+}
+
+void QueryResultMysqlStmt::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = 0;
+
+    std::vector<Value>().swap(mValues);
+    std::vector<char>().swap(mText);
+    std::vector<char>().swap(mNumberText);
+    std::vector<enum_field_types>().swap(mNativeTypes);
+}
 #endif
@@ -39,11 +39,50 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+        static bool IsDecimal(enum_field_types mysqlType) { return mysqlType == FIELD_TYPE_DECIMAL || mysqlType == FIELD_TYPE_NEWDECIMAL; }
+
+    protected:
+        virtual void EndQuery();
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
+        MYSQL_RES* mResult;
+};
+
+/// Result of a prepared statement query. Rows are copied from the binary bound
+/// statement buffers, integer and float columns are stored as numbers,
+/// DECIMAL columns keep the server's text.
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        QueryResultMysqlStmt(MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount);
+
+        ~QueryResultMysqlStmt();
+
+        // copy the row currently fetched into the statement output binds
+        void AddRow(const MYSQL_BIND* binds);
+
+        bool NextRow() override;
+
+    private:
+        struct Value
+        {
+            union
+            {
+                uint64 integer;
+                double real;
+                size_t text;                                // offset in mText
+            };
+            bool isNull;
+        };
+
         void EndQuery();
 
-        MYSQL_RES* mResult;
+        std::vector<Value> mValues;                         // mFieldCount values per row
+        std::vector<char> mText;                            // zero terminated string values
+        std::vector<char> mNumberText;                      // Field::NUMBER_TEXT_SIZE bytes per column for GetString() of numbers
+        std::vector<enum_field_types> mNativeTypes;         // column types reported by the server
+        uint64 mNextRow;
 };
 #endif
 #endif
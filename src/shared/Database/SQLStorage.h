@@ -20,12 +20,15 @@
 #define SQLSTORAGE_H
 
 #include "Common.h"
+#include "Utilities/FlatHashMap.h"
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
+#include "SQLStorageSnapshot.h"
 
 class SQLStorageBase
 {
     template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
+    friend class SQLStorageSnapshot;
 
     public:
         char const* GetTableName() const { return m_tableName; }
@@ -168,7 +171,7 @@ class SQLHashStorage : public SQLStorageBase
         void Free() override;
 
     private:
-        typedef UNORDERED_MAP<uint32 /*recordId*/, char* /*record*/> RecordMap;
+        typedef FlatHashMap<uint32 /*recordId*/, char* /*record*/> RecordMap;
         RecordMap m_indexMap;
 };
 
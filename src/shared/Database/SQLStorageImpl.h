@@ -167,6 +167,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeValue(char const* v
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    if (sStorageSnapshot.Restore(store))
+        return;
+
     Field* fields = NULL;
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
     if (!result)
@@ -189,7 +192,8 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         delete result;
     }
 
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+    // rows are copied into the storage one by one, no need to buffer the whole table
+    result = WorldDatabase.PQueryStreamed("SELECT * FROM %s", store.GetTableName());
 
     if (!result)
     {
@@ -248,13 +252,22 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
 
+    // the snapshot needs the index of every record
+    bool snapshot = sStorageSnapshot.IsOpen();
+    std::vector<uint32> recordIds;
+    if (snapshot)
+        recordIds.reserve(recordCount);
+
     BarGoLink bar(recordCount);
     do
     {
         fields = result->Fetch();
         bar.step();
 
-        char* record = store.createRecord(fields[0].GetUInt32());
+        uint32 recordId = fields[0].GetUInt32();
+        char* record = store.createRecord(recordId);
+        if (snapshot)
+            recordIds.push_back(recordId);
         offset = 0;
 
         // dependend on dest-size
@@ -304,6 +317,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    if (snapshot)
+        sStorageSnapshot.Store(store, recordIds);
 }
 
 #endif
@@ -0,0 +1,469 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SQLStorageSnapshot.h"
+#include "Database/SQLStorage.h"
+#include "Log.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+INSTANTIATE_SINGLETON_1(SQLStorageSnapshot);
+
+// increase on any change of the file layout
+static const uint32 SNAPSHOT_VERSION = 1;
+static const char SNAPSHOT_MAGIC[4] = { 'S', 'Q', 'L', 'S' };
+static const uint32 SNAPSHOT_NULL_STRING = 0xFFFFFFFF;
+
+struct SnapshotHeader
+{
+    char magic[4];
+    uint32 version;
+    uint32 pointerSize;                                     // records hold string pointers
+    uint32 sectionCount;
+    uint64 dependencyHash;
+    uint64 payloadSize;
+    uint64 payloadChecksum;
+};
+
+// FNV-1a
+static uint64 Checksum(uint8 const* data, size_t size, uint64 hash = UI64LIT(14695981039346656037))
+{
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * UI64LIT(1099511628211);
+
+    return hash;
+}
+
+// sizes as used by SQLStorageLoaderBase::Load, false for formats that can't be saved
+static bool GetRecordLayout(char const* format, uint32& recordSize, std::vector<uint32>& stringOffsets)
+{
+    recordSize = 0;
+    for (uint32 x = 0; format[x]; ++x)
+    {
+        switch (format[x])
+        {
+            case FT_LOGIC:      recordSize += sizeof(bool);   break;
+            case FT_BYTE:
+            case FT_NA_BYTE:    recordSize += sizeof(char);   break;
+            case FT_INT:
+            case FT_NA:         recordSize += sizeof(uint32); break;
+            case FT_FLOAT:
+            case FT_NA_FLOAT:   recordSize += sizeof(float);  break;
+            case FT_STRING:
+                stringOffsets.push_back(recordSize);
+                recordSize += sizeof(char*);
+                break;
+            default:                                        // pointer defaults are set by loaders to anything
+                return false;
+        }
+    }
+
+    return true;
+}
+
+class SnapshotReader
+{
+    public:
+        SnapshotReader(uint8 const* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+        template<class T>
+        bool Read(T& value)
+        {
+            if (uint8 const* data = Skip(sizeof(T)))
+            {
+                memcpy(&value, data, sizeof(T));
+                return true;
+            }
+            return false;
+        }
+
+        bool ReadString(std::string& value)
+        {
+            uint32 length;
+            if (!Read(length))
+                return false;
+
+            uint8 const* data = Skip(length);
+            if (!data)
+                return false;
+
+            value.assign(reinterpret_cast<char const*>(data), length);
+            return true;
+        }
+
+        uint8 const* Skip(uint64 size)
+        {
+            if (size > uint64(m_end - m_pos))
+                return NULL;
+
+            uint8 const* data = m_pos;
+            m_pos += size;
+            return data;
+        }
+
+        bool IsEnd() const { return m_pos == m_end; }
+
+    private:
+        uint8 const* m_pos;
+        uint8 const* m_end;
+};
+
+class SnapshotWriter
+{
+    public:
+        explicit SnapshotWriter(std::vector<uint8>& buffer) : m_buffer(buffer) {}
+
+        template<class T>
+        void Write(T value) { Append(&value, sizeof(T)); }
+
+        void WriteString(char const* value)
+        {
+            uint32 length = strlen(value);
+            Write(length);
+            Append(value, length);
+        }
+
+        void Append(void const* data, size_t size)
+        {
+            uint8 const* bytes = static_cast<uint8 const*>(data);
+            m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        }
+
+    private:
+        std::vector<uint8>& m_buffer;
+};
+
+SQLStorageSnapshot::SQLStorageSnapshot() : m_db(NULL), m_dependencyHash(0), m_region(NULL), m_changed(false)
+{
+}
+
+SQLStorageSnapshot::~SQLStorageSnapshot()
+{
+    delete m_region;
+}
+
+void SQLStorageSnapshot::Open(char const* filename, Database& db, char const* const* dependencies, uint32 dependencyCount)
+{
+    Close();
+
+    m_filename = filename;
+    m_db = &db;
+
+    m_dependencyHash = Checksum(reinterpret_cast<uint8 const*>(&SNAPSHOT_VERSION), sizeof(SNAPSHOT_VERSION));
+    for (uint32 i = 0; i < dependencyCount; ++i)
+    {
+        uint64 checksum;
+        if (!GetTableChecksum(dependencies[i], checksum))
+        {
+            sLog.outError("Static data snapshot disabled, no checksum for table `%s`", dependencies[i]);
+            m_db = NULL;
+            return;
+        }
+
+        m_dependencyHash = Checksum(reinterpret_cast<uint8 const*>(dependencies[i]), strlen(dependencies[i]), m_dependencyHash);
+        m_dependencyHash = Checksum(reinterpret_cast<uint8 const*>(&checksum), sizeof(checksum), m_dependencyHash);
+    }
+
+    if (MapFile())
+        sLog.outString("Static data snapshot %s with %u tables opened", m_filename.c_str(), uint32(m_sections.size()));
+    else
+        sLog.outString("Static data snapshot %s missing or outdated, it will be created", m_filename.c_str());
+}
+
+bool SQLStorageSnapshot::MapFile()
+{
+    try
+    {
+        boost::interprocess::file_mapping file(m_filename.c_str(), boost::interprocess::read_only);
+        m_region = new boost::interprocess::mapped_region(file, boost::interprocess::read_only);
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        return false;
+    }
+
+    uint8 const* data = static_cast<uint8 const*>(m_region->get_address());
+    size_t size = m_region->get_size();
+
+    SnapshotHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid)
+    {
+        memcpy(&header, data, sizeof(header));
+        valid = memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == SNAPSHOT_VERSION && header.pointerSize == sizeof(char*) &&
+                header.dependencyHash == m_dependencyHash && header.payloadSize == size - sizeof(header) &&
+                header.payloadChecksum == Checksum(data + sizeof(header), size - sizeof(header));
+    }
+
+    SnapshotReader reader(data + sizeof(header), valid ? size - sizeof(header) : 0);
+    for (uint32 i = 0; valid && i < header.sectionCount; ++i)
+    {
+        uint32 sectionSize;
+        uint8 const* sectionData = NULL;
+        std::string table;
+
+        valid = reader.Read(sectionSize) && (sectionData = reader.Skip(sectionSize)) != NULL &&
+                SnapshotReader(sectionData, sectionSize).ReadString(table);
+        if (!valid)
+            break;
+
+        m_sections.push_back(Section(table));
+        m_sections.back().data = sectionData;
+        m_sections.back().size = sectionSize;
+    }
+
+    if (!valid || !reader.IsEnd())
+    {
+        m_sections.clear();
+        delete m_region;
+        m_region = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+bool SQLStorageSnapshot::GetTableChecksum(char const* table, uint64& checksum)
+{
+    // computed by the server, no rows are transferred
+    QueryResult* result = m_db->PQuery("CHECKSUM TABLE `%s`", table);
+    if (!result)
+        return false;
+
+    Field* fields = result->Fetch();
+    bool found = result->GetFieldCount() >= 2 && !fields[1].IsNULL();
+    if (found)
+        checksum = fields[1].GetUInt64();
+
+    delete result;
+    return found;
+}
+
+SQLStorageSnapshot::Section* SQLStorageSnapshot::FindSection(char const* table)
+{
+    for (Sections::iterator itr = m_sections.begin(); itr != m_sections.end(); ++itr)
+        if (itr->table == table)
+            return &*itr;
+
+    return NULL;
+}
+
+bool SQLStorageSnapshot::Restore(SQLStorageBase& storage)
+{
+    if (!m_db)
+        return false;
+
+    // sections of the file only, a section saved in this run is never restored
+    Section* section = FindSection(storage.GetTableName());
+    if (!section || !section->buffer.empty())
+        return false;
+
+    uint32 recordSize;
+    std::vector<uint32> stringOffsets;
+    if (!GetRecordLayout(storage.GetDstFormat(), recordSize, stringOffsets))
+        return false;
+
+    SnapshotReader reader(section->data, section->size);
+    std::string table, srcFormat, dstFormat;
+    uint64 checksum, currentChecksum;
+    uint32 maxEntry, recordCount, savedRecordSize;
+    if (!reader.ReadString(table) || !reader.Read(checksum) || !reader.ReadString(srcFormat) || !reader.ReadString(dstFormat) ||
+            !reader.Read(maxEntry) || !reader.Read(recordCount) || !reader.Read(savedRecordSize))
+        return false;
+
+    if (srcFormat != storage.GetSrcFormat() || dstFormat != storage.GetDstFormat() || savedRecordSize != recordSize)
+        return false;
+
+    if (!GetTableChecksum(storage.GetTableName(), currentChecksum) || currentChecksum != checksum)
+        return false;
+
+    uint8 const* recordIds = reader.Skip(uint64(recordCount) * sizeof(uint32));
+    uint8 const* records = reader.Skip(uint64(recordCount) * recordSize);
+    if (!recordIds || !records)
+        return false;
+
+    // check the strings before anything is changed in the storage
+    SnapshotReader stringReader = reader;
+    for (uint64 i = 0; i < uint64(recordCount) * stringOffsets.size(); ++i)
+    {
+        uint32 length;
+        if (!stringReader.Read(length) || (length != SNAPSHOT_NULL_STRING && !stringReader.Skip(length)))
+            return false;
+    }
+
+    storage.prepareToLoad(maxEntry, recordCount, recordSize);
+
+    for (uint32 i = 0; i < recordCount; ++i)
+    {
+        uint32 recordId;
+        memcpy(&recordId, recordIds + i * sizeof(uint32), sizeof(uint32));
+
+        char* record = storage.createRecord(recordId);
+        memcpy(record, records + size_t(i) * recordSize, recordSize);
+
+        for (std::vector<uint32>::const_iterator itr = stringOffsets.begin(); itr != stringOffsets.end(); ++itr)
+        {
+            uint32 length;
+            reader.Read(length);
+
+            char* value = NULL;
+            if (length != SNAPSHOT_NULL_STRING)
+            {
+                value = new char[length + 1];
+                memcpy(value, reader.Skip(length), length);
+                value[length] = 0;
+            }
+            memcpy(record + *itr, &value, sizeof(value));
+        }
+    }
+
+    sLog.outString("Loaded %u records of %s from static data snapshot", recordCount, storage.GetTableName());
+    return true;
+}
+
+void SQLStorageSnapshot::Store(SQLStorageBase const& storage, std::vector<uint32> const& recordIds)
+{
+    if (!m_db)
+        return;
+
+    uint32 recordSize;
+    std::vector<uint32> stringOffsets;
+    if (!GetRecordLayout(storage.GetDstFormat(), recordSize, stringOffsets) || recordSize != storage.GetRecordSize() ||
+            recordIds.size() != storage.GetRecordCount())
+        return;
+
+    uint64 checksum;
+    if (!GetTableChecksum(storage.GetTableName(), checksum))
+        return;
+
+    std::vector<uint8> buffer;
+    SnapshotWriter writer(buffer);
+    writer.WriteString(storage.GetTableName());
+    writer.Write(checksum);
+    writer.WriteString(storage.GetSrcFormat());
+    writer.WriteString(storage.GetDstFormat());
+    writer.Write(storage.GetMaxEntry());
+    writer.Write(storage.GetRecordCount());
+    writer.Write(recordSize);
+    if (!recordIds.empty())
+        writer.Append(&recordIds[0], recordIds.size() * sizeof(uint32));
+
+    // string pointers are meaningless in the file, the strings follow the records
+    size_t recordsPos = buffer.size();
+    writer.Append(storage.m_data, size_t(storage.GetRecordCount()) * recordSize);
+    for (uint32 i = 0; i < storage.GetRecordCount(); ++i)
+    {
+        for (std::vector<uint32>::const_iterator itr = stringOffsets.begin(); itr != stringOffsets.end(); ++itr)
+        {
+            size_t offset = recordsPos + size_t(i) * recordSize + *itr;
+            char const* value;
+            memcpy(&value, &buffer[offset], sizeof(value));
+            memset(&buffer[offset], 0, sizeof(value));
+
+            if (value)
+                writer.WriteString(value);
+            else
+                writer.Write(SNAPSHOT_NULL_STRING);
+        }
+    }
+
+    Section* section = FindSection(storage.GetTableName());
+    if (!section)
+    {
+        m_sections.push_back(Section(storage.GetTableName()));
+        section = &m_sections.back();
+    }
+
+    section->buffer.swap(buffer);
+    m_changed = true;
+}
+
+void SQLStorageSnapshot::Close()
+{
+    if (m_changed)
+        Write();
+
+    delete m_region;
+    m_region = NULL;
+    m_sections.clear();
+    m_db = NULL;
+    m_changed = false;
+}
+
+void SQLStorageSnapshot::Write()
+{
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.pointerSize = sizeof(char*);
+    header.sectionCount = m_sections.size();
+    header.dependencyHash = m_dependencyHash;
+    header.payloadSize = 0;
+    header.payloadChecksum = Checksum(NULL, 0);
+
+    for (Sections::const_iterator itr = m_sections.begin(); itr != m_sections.end(); ++itr)
+    {
+        uint32 size = itr->buffer.empty() ? itr->size : itr->buffer.size();
+        uint8 const* data = itr->buffer.empty() ? itr->data : &itr->buffer[0];
+
+        header.payloadChecksum = Checksum(reinterpret_cast<uint8 const*>(&size), sizeof(size), header.payloadChecksum);
+        header.payloadChecksum = Checksum(data, size, header.payloadChecksum);
+        header.payloadSize += sizeof(size) + size;
+    }
+
+    // a crash while writing must not leave a broken snapshot behind
+    std::string tmpFilename = m_filename + ".tmp";
+    FILE* file = fopen(tmpFilename.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("Static data snapshot %s can't be created", tmpFilename.c_str());
+        return;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (Sections::const_iterator itr = m_sections.begin(); written && itr != m_sections.end(); ++itr)
+    {
+        uint32 size = itr->buffer.empty() ? itr->size : itr->buffer.size();
+        uint8 const* data = itr->buffer.empty() ? itr->data : &itr->buffer[0];
+
+        written = fwrite(&size, sizeof(size), 1, file) == 1 && (size == 0 || fwrite(data, size, 1, file) == 1);
+    }
+
+    written = fclose(file) == 0 && written;
+
+    // the old file must not be mapped for replacing it on all platforms
+    delete m_region;
+    m_region = NULL;
+
+    if (!written)
+    {
+        sLog.outError("Static data snapshot %s can't be written", tmpFilename.c_str());
+        remove(tmpFilename.c_str());
+        return;
+    }
+
+    remove(m_filename.c_str());
+    if (rename(tmpFilename.c_str(), m_filename.c_str()) != 0)
+    {
+        sLog.outError("Static data snapshot %s can't be renamed to %s", tmpFilename.c_str(), m_filename.c_str());
+        return;
+    }
+
+    sLog.outString("Static data snapshot %s written with %u tables (" UI64FMTD " bytes)", m_filename.c_str(), header.sectionCount, header.payloadSize + sizeof(header));
+}
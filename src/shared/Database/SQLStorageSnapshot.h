@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLSTORAGE_SNAPSHOT_H
+#define SQLSTORAGE_SNAPSHOT_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+class Database;
+class SQLStorageBase;
+
+namespace boost { namespace interprocess { class mapped_region; } }
+
+/**
+ * Binary snapshot of the loaded SQL storages (creature_template, item_template, ...)
+ *
+ * Each storage is saved as a section holding the records as they were produced by the loader,
+ * their strings and the checksum of the table. At next startup the file is mapped and a storage
+ * is filled from its section instead of the database when the table checksum, the formats and
+ * the record size still match, validation and post-processing of the loaded data run as usual.
+ * Storage loaders may use data of other tables (script names), these are checked as a whole.
+ * Storages with pointer default fields can't be saved and are always loaded from the database.
+ *
+ * The file is rewritten at Close() when any storage had to be loaded from the database.
+ */
+class SQLStorageSnapshot
+{
+    public:
+        SQLStorageSnapshot();
+        ~SQLStorageSnapshot();
+
+        /// Use the snapshot file, dependencies are tables read by the loaders besides their own table
+        void Open(char const* filename, Database& db, char const* const* dependencies, uint32 dependencyCount);
+        /// Write the updated snapshot if needed and stop using it
+        void Close();
+
+        bool IsOpen() const { return m_db != NULL; }
+
+        /// Fill the storage from its section, false if it must be loaded from the database
+        bool Restore(SQLStorageBase& storage);
+        /// Save the storage just loaded from the database, recordIds in creation order
+        void Store(SQLStorageBase const& storage, std::vector<uint32> const& recordIds);
+
+    private:
+        struct Section
+        {
+            Section(std::string const& table) : table(table), data(NULL), size(0) {}
+
+            std::string table;
+            uint8 const* data;                              ///< section of the mapped file, or in buffer
+            size_t size;
+            std::vector<uint8> buffer;
+        };
+
+        typedef std::vector<Section> Sections;
+
+        bool MapFile();
+        bool GetTableChecksum(char const* table, uint64& checksum);
+        Section* FindSection(char const* table);
+        void Write();
+
+        std::string m_filename;
+        Database* m_db;
+        uint64 m_dependencyHash;
+        boost::interprocess::mapped_region* m_region;
+
+        Sections m_sections;
+        bool m_changed;                                     ///< a storage was loaded from the database
+};
+
+#define sStorageSnapshot MaNGOS::Singleton<SQLStorageSnapshot>::Instance()
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "DatabaseEnv.h"
+
+SqlBatchInsert::SqlBatchInsert(Database& db, SqlStatementID& rowIndex, SqlStatementID& batchIndex, const char* head, uint32 columns) :
+    m_db(db), m_rowIndex(rowIndex), m_batchIndex(batchIndex), m_head(head), m_columns(columns)
+{
+    m_params.reserve(BATCH_ROWS * m_columns);
+}
+
+SqlBatchInsert::~SqlBatchInsert()
+{
+    Flush();
+}
+
+void SqlBatchInsert::Flush()
+{
+    while (m_params.size() >= m_columns)
+        Execute(m_rowIndex, 1);
+
+    if (!m_params.empty())
+    {
+        sLog.outError("SQL batch for '%s' has incomplete row (%u of %u values), not executed", m_head, uint32(m_params.size()), m_columns);
+        m_params.clear();
+    }
+}
+
+void SqlBatchInsert::Execute(SqlStatementID& index, uint32 rows)
+{
+    // statement text is only needed until the id is registered
+    std::string sql;
+    if (!index.initialized())
+    {
+        std::string row = "(";
+        for (uint32 i = 0; i < m_columns; ++i)
+            row += i ? ", ?" : "?";
+        row += ")";
+
+        sql = m_head;
+        for (uint32 i = 0; i < rows; ++i)
+        {
+            if (i)
+                sql += ", ";
+            sql += row;
+        }
+    }
+
+    SqlStatement stmt = m_db.CreateStatement(index, sql.c_str());
+
+    size_t count = rows * m_columns;
+    for (size_t i = 0; i < count; ++i)
+        stmt.addField(m_params[i]);
+
+    stmt.Execute();
+    m_params.erase(m_params.begin(), m_params.begin() + count);
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLBATCHINSERT_H
+#define SQLBATCHINSERT_H
+
+#include "Common.h"
+#include "Database/SqlPreparedStatement.h"
+
+class Database;
+
+/// Collects rows of one table into multi-row prepared "INSERT/REPLACE ... VALUES (?, ?), (?, ?)" statements,
+/// so saving many rows queues a few requests instead of one request per row.
+/// Every BATCH_ROWS complete rows are executed as one statement, rows left at Flush()
+/// (or destruction) are executed one by one with the single row statement.
+class MANGOS_DLL_SPEC SqlBatchInsert
+{
+    public:
+        enum { BATCH_ROWS = 16 };
+
+        /// head is the statement up to the value lists, e.g. "INSERT INTO table (a, b) VALUES ",
+        /// rowIndex and batchIndex are static statement ids of the caller for one and for BATCH_ROWS rows
+        SqlBatchInsert(Database& db, SqlStatementID& rowIndex, SqlStatementID& batchIndex, const char* head, uint32 columns);
+        ~SqlBatchInsert();
+
+        // templates to simplify binding of a 2-4 column row
+        template<typename ParamType1, typename ParamType2>
+        void AddRow(ParamType1 param1, ParamType2 param2)
+        {
+            arg(param1);
+            arg(param2);
+        }
+
+        template<typename ParamType1, typename ParamType2, typename ParamType3>
+        void AddRow(ParamType1 param1, ParamType2 param2, ParamType3 param3)
+        {
+            arg(param1);
+            arg(param2);
+            arg(param3);
+        }
+
+        template<typename ParamType1, typename ParamType2, typename ParamType3, typename ParamType4>
+        void AddRow(ParamType1 param1, ParamType2 param2, ParamType3 param3, ParamType4 param4)
+        {
+            arg(param1);
+            arg(param2);
+            arg(param3);
+            arg(param4);
+        }
+
+        // bind values of wider rows column by column, like SqlStatement
+        void addUInt8(uint8 var) { arg(var); }
+        void addUInt32(uint32 var) { arg(var); }
+        void addInt32(int32 var) { arg(var); }
+        void addUInt64(uint64 var) { arg(var); }
+        void addFloat(float var) { arg(var); }
+        void addString(const char* var) { arg(var); }
+
+        /// execute rows bound so far
+        void Flush();
+
+    private:
+        SqlBatchInsert(SqlBatchInsert const&);
+        SqlBatchInsert& operator=(SqlBatchInsert const&);
+
+        template<typename ParamType>
+        void arg(ParamType val)
+        {
+            m_params.push_back(SqlStmtFieldData(val));
+            if (m_params.size() == BATCH_ROWS * m_columns)
+                Execute(m_batchIndex, BATCH_ROWS);
+        }
+
+        /// execute the first rows of m_params with the statement for this row count
+        void Execute(SqlStatementID& index, uint32 rows);
+
+        Database& m_db;
+        SqlStatementID& m_rowIndex;
+        SqlStatementID& m_batchIndex;
+        const char* m_head;
+        uint32 m_columns;
+        SqlStmtParameters::ParameterContainer m_params;     // values of rows not executed yet
+};
+
+#endif
@@ -20,7 +20,8 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase) :
+    m_queueSize(0), m_dbEngine(db), m_dbConnection(conn), m_pingDatabase(pingDatabase), m_running(true), m_pending(false)
 {
 }
 
@@ -30,32 +31,64 @@ SqlDelayThread::~SqlDelayThread()
     ProcessRequests();
 }
 
+bool SqlDelayThread::Delay(SqlOperation* sql)
+{
+    uint32 queueSize = ++m_queueSize;
+    m_sqlQueue.add(sql);
+
+    // the peak of this thread only, the total is sampled when the metrics are dumped
+    SqlMetrics& metrics = m_dbEngine->GetMetrics();
+    if (metrics.IsEnabled())
+        metrics.AddQueueSize(queueSize);
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_wakeLock);
+        m_pending = true;
+    }
+
+    m_wakeCondition.notify_one();
+    return true;
+}
+
 void SqlDelayThread::run()
 {
 #ifndef DO_POSTGRESQL
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
+    // MaxPingTime = 0 would wake the thread without pause, fall back to one minute
+    const uint32 pingIntervalms = m_dbEngine->GetPingIntervall() ? m_dbEngine->GetPingIntervall() : MINUTE * IN_MILLISECONDS;
+    const boost::posix_time::milliseconds pingInterval(pingIntervalms);
+    boost::system_time nextPing = boost::get_system_time() + pingInterval;
 
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
-
-    uint32 loopCounter = 0;
     while (m_running)
     {
+        {
+            boost::unique_lock<boost::mutex> guard(m_wakeLock);
+            // sleep until something is queued, Stop() is called or the connections need a ping
+            while (!m_pending && m_running)
+                if (!m_wakeCondition.timed_wait(guard, nextPing))
+                    break;
+
+            m_pending = false;
+        }
+
         // if the running state gets turned off while sleeping
         // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
-
         ProcessRequests();
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (boost::get_system_time() >= nextPing)
         {
-            loopCounter = 0;
-            m_dbEngine->Ping();
+            nextPing = boost::get_system_time() + pingInterval;
+            if (m_pingDatabase)
+                m_dbEngine->Ping();
         }
     }
 
+    // requests queued between the last ProcessRequests() and Stop(), barrier waits
+    // among them must not be left for the destructor, the other threads wait for them
+    ProcessRequests();
+
 #ifndef DO_POSTGRESQL
     mysql_thread_end();
 #endif
@@ -63,7 +96,12 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
+    {
+        boost::lock_guard<boost::mutex> guard(m_wakeLock);
+        m_running = false;
+    }
+
+    m_wakeCondition.notify_one();
 }
 
 void SqlDelayThread::ProcessRequests()
@@ -73,5 +111,6 @@ void SqlDelayThread::ProcessRequests()
     {
         s->Execute(m_dbConnection);
         delete s;
+        --m_queueSize;
     }
 }
@@ -20,7 +20,10 @@
 #define __SQLDELAYTHREAD_H
 
 #include <boost/thread/mutex.hpp>
-#include "LockedQueue.h"
+#include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
+#include "Common.h"
+#include "MPSCQueue.h"
 #include "Threading.h"
 
 class Database;
@@ -29,23 +32,31 @@ class SqlConnection;
 
 class SqlDelayThread : public MaNGOS::Runnable
 {
-    typedef MaNGOS::LockedQueue<SqlOperation*, boost::mutex> SqlQueue;
+    typedef MaNGOS::MPSCQueue<SqlOperation*> SqlQueue;
 
     private:
         SqlQueue m_sqlQueue;                                ///< Queue of SQL statements
+        boost::atomic<uint32> m_queueSize;                  ///< Statements queued and not executed yet
         Database* m_dbEngine;                               ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                      ///< Pointer to DB connection
+        bool m_pingDatabase;                                ///< Ping all connections of m_dbEngine, only one thread per Database does it
         volatile bool m_running;
 
+        boost::mutex m_wakeLock;
+        boost::condition_variable m_wakeCondition;          ///< signaled when new statement queued or thread stopping
+        bool m_pending;                                     ///< statements were queued since the last wakeup
+
         // process all enqueued requests
         void ProcessRequests();
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase = true);
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
+        bool Delay(SqlOperation* sql);
+        ///< Number of statements waiting for execution
+        uint32 GetQueueSize() const { return m_queueSize; }
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
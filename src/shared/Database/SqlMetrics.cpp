@@ -0,0 +1,199 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SqlMetrics.h"
+#include "DatabaseEnv.h"
+#include <boost/thread/lock_guard.hpp>
+#include <chrono>
+
+// upper bounds of the histogram buckets in microseconds, the last bucket is unbounded
+static const uint64 s_bucketLimits[SqlMetrics::HISTOGRAM_BUCKETS - 1] = { 100, 1000, 10000, 100000, 1000000 };
+
+SqlMetrics::Histogram::Histogram() : count(0), totalUs(0), maxUs(0)
+{
+    memset(buckets, 0, sizeof(buckets));
+}
+
+void SqlMetrics::Histogram::Add(uint64 us)
+{
+    ++count;
+    totalUs += us;
+    if (us > maxUs)
+        maxUs = us;
+
+    uint32 bucket = 0;
+    while (bucket < HISTOGRAM_BUCKETS - 1 && us >= s_bucketLimits[bucket])
+        ++bucket;
+
+    ++buckets[bucket];
+}
+
+SqlMetrics::SqlMetrics(Database& db) : m_db(db), m_enabled(false), m_queuePeak(0)
+{
+}
+
+uint64 SqlMetrics::GetTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SqlMetrics::AddStatement(int stmtId, uint64 us)
+{
+    boost::lock_guard<boost::mutex> guard(m_mutex);
+    m_statements[stmtId].Add(us);
+}
+
+void SqlMetrics::AddQuery(const char* sql, uint64 us)
+{
+    // normalize before locking, the shape is the expensive part
+    std::string shape = GetQueryShape(sql);
+
+    boost::lock_guard<boost::mutex> guard(m_mutex);
+
+    QueryMap::iterator itr = m_queries.find(shape);
+    if (itr == m_queries.end())
+    {
+        if (m_queries.size() >= MAX_QUERY_SHAPES)
+            shape = "<other>";
+
+        itr = m_queries.insert(QueryMap::value_type(shape, Histogram())).first;
+    }
+
+    itr->second.Add(us);
+}
+
+void SqlMetrics::AddLockWait(uint64 us)
+{
+    boost::lock_guard<boost::mutex> guard(m_mutex);
+    m_lockWaits.Add(us);
+}
+
+void SqlMetrics::AddQueueSize(uint32 size)
+{
+    boost::lock_guard<boost::mutex> guard(m_mutex);
+    if (size > m_queuePeak)
+        m_queuePeak = size;
+}
+
+void SqlMetrics::Reset()
+{
+    boost::lock_guard<boost::mutex> guard(m_mutex);
+    m_statements.clear();
+    m_queries.clear();
+    m_lockWaits = Histogram();
+    m_queuePeak = 0;
+}
+
+std::string SqlMetrics::GetQueryShape(const char* sql)
+{
+    std::string shape;
+    shape.reserve(MAX_SHAPE_LENGTH);
+
+    for (const char* c = sql; *c && shape.size() < MAX_SHAPE_LENGTH; ++c)
+    {
+        char last = shape.empty() ? ' ' : shape[shape.size() - 1];
+
+        if (*c == '\'' || *c == '"')
+        {
+            // string literal, escaped quotes do not end it
+            char quote = *c;
+            while (c[1] && c[1] != quote)
+            {
+                if (c[1] == '\\' && c[2])
+                    ++c;
+                ++c;
+            }
+            if (c[1])
+                ++c;
+
+            shape += '?';
+        }
+        else if (isdigit((unsigned char)*c) && !isalnum((unsigned char)last) && last != '_')
+        {
+            // number literal, identifiers with digits like `table2` are kept
+            while (isalnum((unsigned char)c[1]) || c[1] == '.')
+                ++c;
+
+            shape += '?';
+        }
+        else if (isspace((unsigned char)*c))
+        {
+            if (last != ' ')
+                shape += ' ';
+        }
+        else
+            shape += *c;
+    }
+
+    return shape;
+}
+
+std::string SqlMetrics::FormatHistogram(Histogram const& histogram, std::string const& name)
+{
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%9.1f | %7u | %7u | %7u | %u/%u/%u/%u/%u/%u | ",
+             histogram.totalUs / 1000.0, histogram.count, uint32(histogram.totalUs / histogram.count), uint32(histogram.maxUs),
+             histogram.buckets[0], histogram.buckets[1], histogram.buckets[2], histogram.buckets[3], histogram.buckets[4], histogram.buckets[5]);
+
+    return buf + name;
+}
+
+static bool CompareTotalTime(std::pair<std::string, SqlMetrics::Histogram> const& lhs, std::pair<std::string, SqlMetrics::Histogram> const& rhs)
+{
+    return lhs.second.totalUs > rhs.second.totalUs;
+}
+
+void SqlMetrics::Report(std::vector<std::string>& lines, uint32 maxEntries) const
+{
+    typedef std::vector<std::pair<int, Histogram> > StatementEntries;
+    typedef std::vector<std::pair<std::string, Histogram> > Entries;
+
+    StatementEntries statements;
+    Entries entries;
+    Histogram lockWaits;
+    uint32 queuePeak;
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        statements.assign(m_statements.begin(), m_statements.end());
+        entries.assign(m_queries.begin(), m_queries.end());
+        lockWaits = m_lockWaits;
+        queuePeak = m_queuePeak;
+    }
+
+    // statement texts are looked up without holding m_mutex
+    for (StatementEntries::const_iterator itr = statements.begin(); itr != statements.end(); ++itr)
+        entries.push_back(Entries::value_type("[stmt] " + m_db.GetStmtString(itr->first), itr->second));
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "Async queue: %u requests (peak %u on one connection)", m_db.GetAsyncQueueSize(), queuePeak);
+    lines.push_back(buf);
+    snprintf(buf, sizeof(buf), "Contended connection locks: %u (total %.1f ms, max %.1f ms)",
+             lockWaits.count, lockWaits.totalUs / 1000.0, lockWaits.maxUs / 1000.0);
+    lines.push_back(buf);
+
+    if (entries.empty())
+        return;
+
+    size_t shown = std::min(entries.size(), size_t(maxEntries));
+    std::partial_sort(entries.begin(), entries.begin() + shown, entries.end(), CompareTotalTime);
+
+    lines.push_back(" total ms |   calls |  avg us |  max us | <100us/<1ms/<10ms/<100ms/<1s/>=1s | query");
+    for (size_t i = 0; i < shown; ++i)
+        lines.push_back(FormatHistogram(entries[i].second, entries[i].first));
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLMETRICS_H
+#define SQLMETRICS_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMapSet.h"
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/noncopyable.hpp>
+
+class Database;
+
+/**
+ * Operation metrics of one Database.
+ *
+ * Collects call counts and latency histograms per prepared statement and per
+ * ad-hoc query shape (the query text with literals replaced by '?'), the time
+ * spent waiting for connection locks and the peak async queue depth.
+ * Collection is disabled by default, callers check IsEnabled() before timing.
+ */
+class SqlMetrics : public boost::noncopyable
+{
+    public:
+        enum
+        {
+            HISTOGRAM_BUCKETS   = 6,                        ///< <100us, <1ms, <10ms, <100ms, <1s, >=1s
+            MAX_QUERY_SHAPES    = 1000,                     ///< later shapes are counted as "<other>"
+            MAX_SHAPE_LENGTH    = 120
+        };
+
+        struct Histogram
+        {
+            Histogram();
+
+            void Add(uint64 us);
+
+            uint32 count;
+            uint64 totalUs;
+            uint64 maxUs;
+            uint32 buckets[HISTOGRAM_BUCKETS];
+        };
+
+        explicit SqlMetrics(Database& db);
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        bool IsEnabled() const { return m_enabled; }
+
+        /// Monotonic time in microseconds for measuring operations
+        static uint64 GetTimeUs();
+
+        void AddStatement(int stmtId, uint64 us);
+        void AddQuery(const char* sql, uint64 us);
+        void AddLockWait(uint64 us);
+        void AddQueueSize(uint32 size);
+
+        void Reset();
+
+        /// Append report lines, entries sorted by total time and limited to maxEntries
+        void Report(std::vector<std::string>& lines, uint32 maxEntries) const;
+
+    private:
+        typedef UNORDERED_MAP<int, Histogram> StatementMap;
+        typedef UNORDERED_MAP<std::string, Histogram> QueryMap;
+
+        static std::string GetQueryShape(const char* sql);
+        static std::string FormatHistogram(Histogram const& histogram, std::string const& name);
+
+        Database& m_db;
+        boost::atomic<bool> m_enabled;
+
+        mutable boost::mutex m_mutex;                       ///< guards everything below
+        StatementMap m_statements;
+        QueryMap m_queries;
+        Histogram m_lockWaits;
+        uint32 m_queuePeak;
+};
+
+#endif
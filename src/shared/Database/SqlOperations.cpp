@@ -80,6 +80,59 @@ bool SqlPreparedRequest::Execute(SqlConnection* conn)
     return conn->ExecuteStmt(m_nIndex, *m_param);
 }
 
+/// ---- ORDERING BETWEEN ASYNC CONNECTIONS ----
+
+void SqlBarrier::Arrive()
+{
+    boost::unique_lock<boost::mutex> guard(m_lock);
+    --m_waiters;
+    m_condition.notify_all();
+
+    while (!m_released)
+        m_condition.wait(guard);
+}
+
+void SqlBarrier::WaitForAll()
+{
+    boost::unique_lock<boost::mutex> guard(m_lock);
+    while (m_waiters)
+        m_condition.wait(guard);
+}
+
+bool SqlBarrier::AddRequest()
+{
+    boost::lock_guard<boost::mutex> guard(m_lock);
+    if (m_released)
+        return false;
+
+    ++m_requests;
+    return true;
+}
+
+void SqlBarrier::RequestDone()
+{
+    boost::lock_guard<boost::mutex> guard(m_lock);
+    if (--m_requests)
+        return;
+
+    m_released = true;
+    m_condition.notify_all();
+}
+
+bool SqlBarrierWait::Execute(SqlConnection* /*conn*/)
+{
+    m_barrier->Arrive();
+    return true;
+}
+
+bool SqlBarrierRequest::Execute(SqlConnection* conn)
+{
+    m_barrier->WaitForAll();
+    bool result = m_request->Execute(conn);
+    m_barrier->RequestDone();
+    return result;
+}
+
 /// ---- ASYNC QUERIES ----
 
 bool SqlQuery::Execute(SqlConnection* conn)
@@ -107,19 +160,20 @@ void SqlResultQueue::Update()
     }
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !db || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
+    holderEx->SetSerialId(m_serialId);
+    db->DelayOperation(holderEx);
     return true;
 }
 
-bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
+bool SqlQueryHolder::CheckIndex(size_t index, const char* sql) const
 {
     if (m_queries.size() <= index)
     {
@@ -127,18 +181,55 @@ bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
         return false;
     }
 
-    if (m_queries[index].first != NULL)
+    if (m_queries[index].pending())
     {
         sLog.outError("Attempt assign query to holder index (" SIZEFMTD ") where other query stored (Old: [%s] New: [%s])",
-                      index, m_queries[index].first, sql);
+                      index, m_queries[index].sql ? m_queries[index].sql : "<statement>", sql);
         return false;
     }
 
+    return true;
+}
+
+bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
+{
+    if (!CheckIndex(index, sql))
+        return false;
+
     /// not executed yet, just stored (it's not called a holder for nothing)
-    m_queries[index] = SqlResultPair(mangos_strdup(sql), (QueryResult*)NULL);
+    m_queries[index].sql = mangos_strdup(sql);
+    m_queries[index].result = NULL;
     return true;
 }
 
+bool SqlQueryHolder::SetStatement(size_t index, SqlStatement& stmt)
+{
+    if (!CheckIndex(index, "<statement>"))
+        return false;
+
+    SqlStmtParameters* args = stmt.detach();
+    // verify amount of bound parameters
+    if (args->boundParams() != stmt.arguments())
+    {
+        sLog.outError("SQL ERROR: wrong amount of parameters (%i instead of %i) for holder index (" SIZEFMTD ")", args->boundParams(), stmt.arguments(), index);
+        delete args;
+        return false;
+    }
+
+    m_queries[index].stmtId = stmt.ID();
+    m_queries[index].params = args;
+    m_queries[index].result = NULL;
+    return true;
+}
+
+void SqlQueryHolder::FreeQuery(SqlHolderQuery& query)
+{
+    delete[](const_cast<char*>(query.sql));
+    delete query.params;
+    query.sql = NULL;
+    query.params = NULL;
+}
+
 bool SqlQueryHolder::SetPQuery(size_t index, const char* format, ...)
 {
     if (!format)
@@ -167,13 +258,9 @@ QueryResult* SqlQueryHolder::GetResult(size_t index)
     if (index < m_queries.size())
     {
         /// the query strings are freed on the first GetResult or in the destructor
-        if (m_queries[index].first != NULL)
-        {
-            delete[](const_cast<char*>(m_queries[index].first));
-            m_queries[index].first = NULL;
-        }
+        FreeQuery(m_queries[index]);
         /// when you get a result aways remember to delete it!
-        return m_queries[index].second;
+        return m_queries[index].result;
     }
     else
         return NULL;
@@ -183,7 +270,7 @@ void SqlQueryHolder::SetResult(size_t index, QueryResult* result)
 {
     /// store the result in the holder
     if (index < m_queries.size())
-        m_queries[index].second = result;
+        m_queries[index].result = result;
 }
 
 SqlQueryHolder::~SqlQueryHolder()
@@ -192,10 +279,10 @@ SqlQueryHolder::~SqlQueryHolder()
     {
         /// if the result was never used, free the resources
         /// results used already (getresult called) are expected to be deleted
-        if (m_queries[i].first != NULL)
+        if (m_queries[i].pending())
         {
-            delete[](const_cast<char*>(m_queries[i].first));
-            delete m_queries[i].second;
+            FreeQuery(m_queries[i]);
+            delete m_queries[i].result;
         }
     }
 }
@@ -212,14 +299,8 @@ bool SqlQueryHolderEx::Execute(SqlConnection* conn)
         return false;
 
     LOCK_DB_CONN(conn);
-    /// we can do this, we are friends
-    std::vector<SqlQueryHolder::SqlResultPair>& queries = m_holder->m_queries;
-    for (size_t i = 0; i < queries.size(); ++i)
-    {
-        /// execute all queries in the holder and pass the results
-        char const* sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, conn->Query(sql));
-    }
+    /// execute all queries in the holder in parallel on the query connections and pass the results
+    conn->DB().GetQueryPool().Execute(*m_holder, conn);
 
     /// sync with the caller thread
     m_queue->add(m_callback);
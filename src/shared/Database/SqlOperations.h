@@ -22,6 +22,8 @@
 #include "Common.h"
 
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/shared_ptr.hpp>
 #include "LockedQueue.h"
 #include <queue>
 #include "Utilities/Callback.h"
@@ -32,13 +34,23 @@ class Database;
 class SqlConnection;
 class SqlDelayThread;
 class SqlStmtParameters;
+class SqlStatement;
 
 class SqlOperation
 {
     public:
+        SqlOperation() : m_serialId(0) {}
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
         virtual ~SqlOperation() {}
+
+        // operations with equal serial id are executed by the same async connection in queue order,
+        // operations without serial id are ordered with the requests of all async connections
+        uint32 GetSerialId() const { return m_serialId; }
+        void SetSerialId(uint32 serialId) { m_serialId = serialId; }
+
+    private:
+        uint32 m_serialId;
 };
 
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
@@ -80,6 +92,57 @@ class SqlPreparedRequest : public SqlOperation
         SqlStmtParameters* m_param;
 };
 
+/// ---- ORDERING BETWEEN ASYNC CONNECTIONS ----
+
+/// Rendezvous of all delay threads of a Database. Requests without serial id may touch
+/// the data of any character, with several async connections they are executed by the
+/// first one only after all connections finished the requests queued before, and the
+/// other connections wait until they are executed. Consecutive requests without serial
+/// id share one barrier, the waiters are released after the last of them.
+class SqlBarrier
+{
+    public:
+        explicit SqlBarrier(uint32 waiters) : m_waiters(waiters), m_requests(1), m_released(false) {}
+
+        // other delay threads: report arrival and block until the requests are executed
+        void Arrive();
+        // executing delay thread: block until all other threads arrived
+        void WaitForAll();
+        // queue one more request behind the barrier, fails if the waiters were released already
+        bool AddRequest();
+        // executing delay thread: request done, the last one releases the waiters
+        void RequestDone();
+
+    private:
+        boost::mutex m_lock;
+        boost::condition_variable m_condition;
+        uint32 m_waiters;
+        uint32 m_requests;
+        bool m_released;
+};
+
+typedef boost::shared_ptr<SqlBarrier> SqlBarrierPtr;
+
+class SqlBarrierWait : public SqlOperation
+{
+    private:
+        SqlBarrierPtr m_barrier;
+    public:
+        SqlBarrierWait(const SqlBarrierPtr& barrier) : m_barrier(barrier) {}
+        bool Execute(SqlConnection* conn) override;
+};
+
+class SqlBarrierRequest : public SqlOperation
+{
+    private:
+        SqlOperation* m_request;
+        SqlBarrierPtr m_barrier;
+    public:
+        SqlBarrierRequest(SqlOperation* request, const SqlBarrierPtr& barrier) : m_request(request), m_barrier(barrier) {}
+        ~SqlBarrierRequest() { delete m_request; }
+        bool Execute(SqlConnection* conn) override;
+};
+
 /// ---- ASYNC QUERIES ----
 
 class SqlQuery;                                             /// contains a single async query
@@ -111,18 +174,39 @@ class SqlQuery : public SqlOperation
 class SqlQueryHolder
 {
         friend class SqlQueryHolderEx;
+        friend class SqlQueryPool;
     private:
-        typedef std::pair<const char*, QueryResult*> SqlResultPair;
-        std::vector<SqlResultPair> m_queries;
+        struct SqlHolderQuery
+        {
+            SqlHolderQuery() : sql(NULL), stmtId(-1), params(NULL), result(NULL) {}
+
+            // pending until the first GetResult, either plain SQL or prepared statement
+            bool pending() const { return sql != NULL || params != NULL; }
+
+            const char* sql;
+            int stmtId;
+            SqlStmtParameters* params;
+            QueryResult* result;
+        };
+        std::vector<SqlHolderQuery> m_queries;
+        uint32 m_serialId;
+
+        bool CheckIndex(size_t index, const char* sql) const;
+        void FreeQuery(SqlHolderQuery& query);
     public:
-        SqlQueryHolder() {}
+        SqlQueryHolder() : m_serialId(0) {}
         ~SqlQueryHolder();
         bool SetQuery(size_t index, const char* sql);
         bool SetPQuery(size_t index, const char* format, ...) ATTR_PRINTF(3, 4);
+        // prepared statement with bound parameters, result rows are binary bound
+        bool SetStatement(size_t index, SqlStatement& stmt);
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        // see SqlOperation::SetSerialId, queries of the holder are ordered with async writes using the same id
+        uint32 GetSerialId() const { return m_serialId; }
+        void SetSerialId(uint32 serialId) { m_serialId = serialId; }
+        bool Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -205,6 +205,8 @@ class MANGOS_DLL_SPEC SqlStatement
 
         bool Execute();
         bool DirectExecute();
+        // synchronous query, result rows are binary bound where the DBMS backend supports it
+        QueryResult* Query();
 
         // templates to simplify 1-4 parameter bindings
         template<typename ParamType1>
@@ -241,6 +243,30 @@ class MANGOS_DLL_SPEC SqlStatement
             return Execute();
         }
 
+        template<typename ParamType1>
+        QueryResult* PQuery(ParamType1 param1)
+        {
+            arg(param1);
+            return Query();
+        }
+
+        template<typename ParamType1, typename ParamType2>
+        QueryResult* PQuery(ParamType1 param1, ParamType2 param2)
+        {
+            arg(param1);
+            arg(param2);
+            return Query();
+        }
+
+        template<typename ParamType1, typename ParamType2, typename ParamType3>
+        QueryResult* PQuery(ParamType1 param1, ParamType2 param2, ParamType3 param3)
+        {
+            arg(param1);
+            arg(param2);
+            arg(param3);
+            return Query();
+        }
+
         // bind parameters with specified type
         void addBool(bool var) { arg(var); }
         void addUInt8(uint8 var) { arg(var); }
@@ -256,10 +282,13 @@ class MANGOS_DLL_SPEC SqlStatement
         void addString(const char* var) { arg(var); }
         void addString(const std::string& var) { arg(var.c_str()); }
         void addString(std::ostringstream& ss) { arg(ss.str().c_str()); ss.str(std::string()); }
+        // bind already typed value, see SqlBatchInsert
+        void addField(const SqlStmtFieldData& data) { get()->addParam(data); }
 
     protected:
         // don't allow anyone except Database class to create static SqlStatement objects
         friend class Database;
+        friend class SqlQueryHolder;
         SqlStatement(const SqlStatementID& index, Database& db) : m_index(index), m_pDB(&db), m_pParams(NULL) {}
 
     private:
@@ -313,6 +342,8 @@ class MANGOS_DLL_SPEC SqlPreparedStatement
 
         // execute statement w/o result set
         virtual bool execute() = 0;
+        // execute query statement, returns NULL for empty result sets like SqlConnection::Query
+        virtual QueryResult* query() = 0;
 
     protected:
         SqlPreparedStatement(const std::string& fmt, SqlConnection& conn) :
@@ -342,6 +373,8 @@ class MANGOS_DLL_SPEC SqlPlainPreparedStatement : public SqlPreparedStatement
         virtual void bind(const SqlStmtParameters& holder) override;
 
         virtual bool execute() override;
+        // no binary protocol available, plain SQL text query
+        virtual QueryResult* query() override;
 
     protected:
         void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt);
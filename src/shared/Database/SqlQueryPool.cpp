@@ -0,0 +1,140 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SqlQueryPool.h"
+#include "Database/SqlOperations.h"
+#include "DatabaseEnv.h"
+#include <boost/bind.hpp>
+
+SqlQueryPool::SqlQueryPool(Database& db) : m_db(db), m_stopping(false)
+{
+}
+
+SqlQueryPool::~SqlQueryPool()
+{
+    Deactivate();
+}
+
+void SqlQueryPool::Activate(std::vector<SqlConnection*> const& connections)
+{
+    MANGOS_ASSERT(m_workerThreads.empty());
+
+    m_stopping = false;
+    for (size_t i = 0; i < connections.size(); ++i)
+        m_workerThreads.push_back(new boost::thread(boost::bind(&SqlQueryPool::WorkerThread, this, connections[i])));
+}
+
+void SqlQueryPool::Deactivate()
+{
+    if (m_workerThreads.empty())
+        return;
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        m_stopping = true;
+    }
+    m_requestCondition.notify_all();
+
+    for (WorkerThreads::iterator itr = m_workerThreads.begin(); itr != m_workerThreads.end(); ++itr)
+    {
+        (*itr)->join();
+        delete *itr;
+    }
+
+    m_workerThreads.clear();
+}
+
+void SqlQueryPool::Execute(SqlQueryHolder& holder, SqlConnection* conn)
+{
+    size_t remaining = 0;
+
+    {
+        boost::lock_guard<boost::mutex> guard(m_mutex);
+        for (size_t i = 0; i < holder.m_queries.size(); ++i)
+        {
+            if (!holder.m_queries[i].pending())
+                continue;
+
+            m_queue.push(QueryRequest(&holder, i, &remaining));
+            ++remaining;
+        }
+    }
+    m_requestCondition.notify_all();
+
+    // take part in executing queued queries, then wait for the ones still executed by workers
+    boost::unique_lock<boost::mutex> guard(m_mutex);
+    while (remaining > 0)
+    {
+        if (m_queue.empty())
+        {
+            m_finishedCondition.wait(guard);
+            continue;
+        }
+
+        QueryRequest request = m_queue.front();
+        m_queue.pop();
+
+        guard.unlock();
+        ExecuteRequest(request, conn);
+        guard.lock();
+
+        if (--*request.m_remaining == 0)
+            m_finishedCondition.notify_all();
+    }
+}
+
+void SqlQueryPool::ExecuteRequest(QueryRequest const& request, SqlConnection* conn)
+{
+    SqlQueryHolder::SqlHolderQuery& query = request.m_holder->m_queries[request.m_index];
+
+    if (query.sql)
+        request.m_holder->SetResult(request.m_index, conn->Query(query.sql));
+    else if (query.params)
+        request.m_holder->SetResult(request.m_index, conn->QueryStmt(query.stmtId, *query.params));
+}
+
+void SqlQueryPool::WorkerThread(SqlConnection* conn)
+{
+    m_db.ThreadStart();
+
+    for (;;)
+    {
+        boost::unique_lock<boost::mutex> guard(m_mutex);
+        while (m_queue.empty() && !m_stopping)
+            m_requestCondition.wait(guard);
+
+        if (m_queue.empty())
+            break;                                          // stopping and nothing left to do
+
+        QueryRequest request = m_queue.front();
+        m_queue.pop();
+
+        guard.unlock();
+        {
+            // the connection is shared with synchronous queries of other threads
+            SqlConnection::Lock connGuard(conn);
+            ExecuteRequest(request, conn);
+        }
+        guard.lock();
+
+        if (--*request.m_remaining == 0)
+            m_finishedCondition.notify_all();
+    }
+
+    m_db.ThreadEnd();
+}
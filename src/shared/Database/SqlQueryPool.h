@@ -0,0 +1,85 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLQUERYPOOL_H
+#define SQLQUERYPOOL_H
+
+#include "Common.h"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/noncopyable.hpp>
+#include <queue>
+
+class Database;
+class SqlConnection;
+class SqlQueryHolder;
+
+/**
+ * Worker pool executing the queries of a SqlQueryHolder in parallel.
+ *
+ * Every worker owns one of the synchronous query connections of the Database.
+ * Execute() queues the pending queries of a holder, executes queued queries itself
+ * on the calling delay thread's connection and returns when all of them are done,
+ * so a holder takes about as long as its slowest queries instead of their sum.
+ * Without workers Execute() runs all queries on the caller's connection.
+ */
+class SqlQueryPool : public boost::noncopyable
+{
+    public:
+        explicit SqlQueryPool(Database& db);
+        ~SqlQueryPool();
+
+        /// Start one worker per connection
+        void Activate(std::vector<SqlConnection*> const& connections);
+        /// Stop and join all workers, queued queries are finished first
+        void Deactivate();
+
+        /// Execute all pending queries of the holder, conn is locked by the caller
+        void Execute(SqlQueryHolder& holder, SqlConnection* conn);
+
+    private:
+        struct QueryRequest
+        {
+            QueryRequest(SqlQueryHolder* holder, size_t index, size_t* remaining) :
+                m_holder(holder), m_index(index), m_remaining(remaining) {}
+
+            SqlQueryHolder* m_holder;
+            size_t m_index;
+            size_t* m_remaining;                            ///< not finished queries of the holder, guarded by m_mutex
+        };
+
+        typedef std::queue<QueryRequest> RequestQueue;
+        typedef std::vector<boost::thread*> WorkerThreads;
+
+        void WorkerThread(SqlConnection* conn);
+        // execute one request, m_mutex must not be held
+        void ExecuteRequest(QueryRequest const& request, SqlConnection* conn);
+
+        Database& m_db;
+        RequestQueue m_queue;
+        WorkerThreads m_workerThreads;
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_requestCondition;       ///< signaled when new requests queued or pool stopping
+        boost::condition_variable m_finishedCondition;      ///< signaled when the last query of a holder is done
+
+        bool m_stopping;
+};
+
+#endif
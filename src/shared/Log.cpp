@@ -25,6 +25,7 @@
 #include "ProgressBar.h"
 
 #include <boost/thread.hpp>
+#include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time_duration.hpp>
 
 #include <stdarg.h>
@@ -57,19 +58,10 @@ LogFilterData logFilterData[LOG_FILTER_COUNT] =
     { "calendar",            "LogFilter_Calendar",           true  },
 };
 
-enum LogType
-{
-    LogNormal = 0,
-    LogDetails,
-    LogDebug,
-    LogError
-};
-
-const int LogType_count = int(LogError) + 1;
-
 Log::Log() :
     raLogfile(NULL), logfile(NULL), gmLogfile(NULL), charLogfile(NULL),
-    dberLogfile(NULL), eventAiErLogfile(NULL), scriptErrLogFile(NULL), worldLogfile(NULL), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL)
+    dberLogfile(NULL), eventAiErLogfile(NULL), scriptErrLogFile(NULL), worldLogfile(NULL), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(NULL),
+    m_writerThread(NULL), m_asyncRunning(false), m_asyncStopping(false), m_asyncDropped(0), m_asyncMaxQueueSize(0), m_asyncFlushInterval(0)
 {
     Initialize();
 }
@@ -219,6 +211,9 @@ void Log::SetLogFileLevel(char* level)
 
 void Log::Initialize()
 {
+    // queued messages may refer to the files reopened below
+    StopAsyncWriter();
+
     /// Common log files data
     m_logsDir = sConfig.GetStringDefault("LogsDir", "");
     if (!m_logsDir.empty())
@@ -270,6 +265,13 @@ void Log::Initialize()
     worldLogfile = openLogFile("WorldLogFile", "WorldLogTimestamp", "a");
 
     ReloadConfigDefaults();
+
+    m_asyncMaxQueueSize = sConfig.GetIntDefault("LogAsync.MaxQueueSize", 100000);
+    // 0 would make the writer thread spin on its timed wait
+    int flushInterval = sConfig.GetIntDefault("LogAsync.FlushInterval", 100);
+    m_asyncFlushInterval = flushInterval < 1 ? 1 : flushInterval;
+    if (sConfig.GetBoolDefault("LogAsync", false))
+        StartAsyncWriter();
 }
 
 void Log::ReloadConfigDefaults()
@@ -326,7 +328,11 @@ FILE* Log::openGmlogPerAccount(uint32 account)
 
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(NULL);
+    outTimestamp(file, time(NULL));
+}
+
+void Log::outTimestamp(FILE* file, time_t t)
+{
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -365,335 +371,318 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+void Log::FormatMessage(LogMessage& msg, const char* format, va_list ap)
 {
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+    // most messages fit the calling thread's stack buffer
+    char buf[4 * 1024];
 
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
+    va_list apCopy;
+    va_copy(apCopy, ap);
+    int len = vsnprintf(buf, sizeof(buf), format, apCopy);
+    va_end(apCopy);
+
+    if (len >= 0 && size_t(len) < sizeof(buf))
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        msg.text.assign(buf, len);
+        return;
     }
 
-    fflush(stdout);
-}
-
-void Log::outString(const char* str, ...)
-{
-    if (!str)
+#if COMPILER == COMPILER_MICROSOFT
+    // _vsnprintf returns -1 for truncated output
+    len = _vscprintf(format, ap);
+#endif
+    if (len < 0)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+    msg.text.resize(len + 1);
+    vsnprintf(&msg.text[0], len + 1, format, ap);
+    msg.text.resize(len);
+}
 
-    if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
+void Log::Write(LogMessage& msg)
+{
+    // synchronous output doesn't touch the queue lock
+    if (m_asyncRunning)
+    {
+        boost::lock_guard<boost::mutex> guard(m_queueMtx);
 
-    if (m_includeTime)
-        outTime();
+        // checked again, the writer may have been stopped meanwhile
+        if (m_asyncRunning)
+        {
+            // the writer can't keep up, drop instead of growing without limit or blocking the caller
+            if (m_asyncMaxQueueSize && m_queue.size() >= m_asyncMaxQueueSize)
+            {
+                ++m_asyncDropped;
+                return;
+            }
 
-    va_list ap;
+            m_queue.push_back(LogMessage());
+            std::swap(m_queue.back(), msg);
 
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+            if (m_queue.size() == ASYNC_BATCH_SIZE)
+                m_queueCondition.notify_one();
 
-    if (m_colored)
-        ResetColor(true);
+            return;
+        }
+    }
 
-    printf("\n");
+    boost::lock_guard<boost::mutex> guard(m_worldLogMtx);
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
+    WriteMessage(msg);
 
+    if (msg.stream)
+        fflush(msg.stream);
+    if (msg.toLogfile && logfile)
         fflush(logfile);
-    }
-
-    fflush(stdout);
+    if (msg.file)
+        fflush(msg.file);
 }
 
-void Log::outError(const char* err, ...)
+void Log::WriteMessage(LogMessage const& msg)
 {
-    if (!err)
-        return;
-
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
-    va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
-
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-    if (logfile)
+    if (msg.stream)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+        bool stdout_stream = msg.stream == stdout;
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        if (m_colored)
+            SetColor(stdout_stream, m_colors[msg.type]);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+        if (m_includeTime)
+        {
+            tm* aTm = localtime(&msg.time);
+            fprintf(msg.stream, "%02d:%02d:%02d ", aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+        }
 
-    fflush(stderr);
-}
+        utf8printf(msg.stream, "%s", msg.text.c_str());
 
-void Log::outErrorDb()
-{
-    if (m_includeTime)
-        outTime();
+        if (m_colored)
+            ResetColor(stdout_stream);
 
-    fprintf(stderr, "\n");
+        fputc('\n', msg.stream);
+    }
 
-    if (logfile)
+    if (msg.toLogfile && logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
+        outTimestamp(logfile, msg.time);
+        fputs(msg.prefix.c_str(), logfile);
+        fputs(msg.text.c_str(), logfile);
+        fputc('\n', logfile);
     }
 
-    if (dberLogfile)
+    if (msg.file)
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        outTimestamp(msg.file, msg.time);
+        fputs(msg.text.c_str(), msg.file);
+        fputc('\n', msg.file);
     }
+}
 
+void Log::FlushFiles()
+{
+    fflush(stdout);
     fflush(stderr);
+
+    FILE* files[] = { logfile, gmLogfile, charLogfile, dberLogfile, eventAiErLogfile, scriptErrLogFile, raLogfile };
+    for (size_t i = 0; i < countof(files); ++i)
+        if (files[i])
+            fflush(files[i]);
 }
 
-void Log::outErrorDb(const char* err, ...)
+void Log::WriterThread()
 {
-    if (!err)
-        return;
+    LogQueue batch;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+    boost::unique_lock<boost::mutex> lock(m_queueMtx);
+    for (;;)
+    {
+        // flush by size or by time, whatever comes first
+        if (m_queue.size() < ASYNC_BATCH_SIZE && !m_asyncStopping)
+            m_queueCondition.timed_wait(lock, boost::posix_time::milliseconds(m_asyncFlushInterval));
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+        batch.swap(m_queue);
+        uint32 dropped = m_asyncDropped;
+        m_asyncDropped = 0;
+        bool stopping = m_asyncStopping;
 
-    if (m_includeTime)
-        outTime();
+        lock.unlock();
 
-    va_list ap;
+        if (!batch.empty() || dropped)
+        {
+            boost::lock_guard<boost::mutex> guard(m_worldLogMtx);
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+            for (LogQueue::const_iterator itr = batch.begin(); itr != batch.end(); ++itr)
+                WriteMessage(*itr);
 
-    if (m_colored)
-        ResetColor(false);
+            if (dropped)
+            {
+                char buf[100];
+                snprintf(buf, sizeof(buf), "Log queue full (LogAsync.MaxQueueSize), %u messages dropped", dropped);
 
-    fprintf(stderr, "\n");
+                LogMessage msg(LogError, stderr, true, "ERROR:");
+                msg.text = buf;
+                WriteMessage(msg);
+            }
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+            FlushFiles();
+            batch.clear();
+        }
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        // no messages are queued after m_asyncStopping is set
+        if (stopping)
+            return;
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        lock.lock();
     }
+}
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+void Log::StartAsyncWriter()
+{
+    if (m_writerThread)
+        return;
 
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+    {
+        boost::lock_guard<boost::mutex> guard(m_queueMtx);
+        m_asyncRunning = true;
+        m_asyncStopping = false;
     }
 
-    fflush(stderr);
+    m_writerThread = new boost::thread(boost::bind(&Log::WriterThread, this));
 }
 
-void Log::outErrorEventAI()
+void Log::StopAsyncWriter()
 {
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
+    if (!m_writerThread)
+        return;
 
-    if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
+        boost::lock_guard<boost::mutex> guard(m_queueMtx);
+        m_asyncRunning = false;
+        m_asyncStopping = true;
     }
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+    m_queueCondition.notify_one();
+    m_writerThread->join();
 
-    fflush(stderr);
+    delete m_writerThread;
+    m_writerThread = NULL;
 }
 
-void Log::outErrorEventAI(const char* err, ...)
+void Log::outString()
 {
-    if (!err)
-        return;
-
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+    LogMessage msg(LogNormal, stdout, true);
+    Write(msg);
+}
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+void Log::outString(const char* str, ...)
+{
+    if (!str)
+        return;
 
-    if (m_includeTime)
-        outTime();
+    LogMessage msg(LogNormal, stdout, true);
 
     va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
     va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+    Write(msg);
+}
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+void Log::outError(const char* err, ...)
+{
+    if (!err)
+        return;
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
+    LogMessage msg(LogError, stderr, true, "ERROR:");
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, err);
+    FormatMessage(msg, err, ap);
+    va_end(ap);
 
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+    Write(msg);
+}
 
-    fflush(stderr);
+void Log::outErrorDb()
+{
+    LogMessage msg(LogError, stderr, true, "ERROR:", dberLogfile);
+    Write(msg);
 }
 
-void Log::outBasic(const char* str, ...)
+void Log::outErrorDb(const char* err, ...)
 {
-    if (!str)
+    if (!err)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+    LogMessage msg(LogError, stderr, true, "ERROR:", dberLogfile);
 
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+    va_list ap;
+    va_start(ap, err);
+    FormatMessage(msg, err, ap);
+    va_end(ap);
 
-        if (m_includeTime)
-            outTime();
+    Write(msg);
+}
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+void Log::outErrorEventAI()
+{
+    LogMessage msg(LogError, stderr, true, "ERROR CreatureEventAI", eventAiErLogfile);
+    Write(msg);
+}
 
-        if (m_colored)
-            ResetColor(true);
+void Log::outErrorEventAI(const char* err, ...)
+{
+    if (!err)
+        return;
 
-        printf("\n");
-    }
+    LogMessage msg(LogError, stderr, true, "ERROR CreatureEventAI: ", eventAiErLogfile);
 
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, err);
+    FormatMessage(msg, err, ap);
+    va_end(ap);
 
-    fflush(stdout);
+    Write(msg);
 }
 
-void Log::outDetail(const char* str, ...)
+void Log::outBasic(const char* str, ...)
 {
     if (!str)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
-
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+    bool toConsole = m_logLevel >= LOG_LVL_BASIC;
+    bool toLogfile = logfile && m_logFileLevel >= LOG_LVL_BASIC;
+    if (!toConsole && !toLogfile)
+        return;
 
-        if (m_includeTime)
-            outTime();
+    LogMessage msg(LogDetails, toConsole ? stdout : NULL, toLogfile);
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
+    va_end(ap);
 
-        if (m_colored)
-            ResetColor(true);
+    Write(msg);
+}
 
-        printf("\n");
-    }
+void Log::outDetail(const char* str, ...)
+{
+    if (!str)
+        return;
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        outTimestamp(logfile);
+    bool toConsole = m_logLevel >= LOG_LVL_DETAIL;
+    bool toLogfile = logfile && m_logFileLevel >= LOG_LVL_DETAIL;
+    if (!toConsole && !toLogfile)
+        return;
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+    LogMessage msg(LogDetails, toConsole ? stdout : NULL, toLogfile);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
+    va_end(ap);
 
-    fflush(stdout);
+    Write(msg);
 }
 
 void Log::outDebug(const char* str, ...)
@@ -701,41 +690,19 @@ void Log::outDebug(const char* str, ...)
     if (!str)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
-
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDebug]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
-    {
-        outTimestamp(logfile);
+    bool toConsole = m_logLevel >= LOG_LVL_DEBUG;
+    bool toLogfile = logfile && m_logFileLevel >= LOG_LVL_DEBUG;
+    if (!toConsole && !toLogfile)
+        return;
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+    LogMessage msg(LogDebug, toConsole ? stdout : NULL, toLogfile);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
+    va_end(ap);
 
-    fflush(stdout);
+    Write(msg);
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -743,107 +710,50 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (!str)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
-
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
+    LogMessage msg(LogDetails, m_logLevel >= LOG_LVL_DETAIL ? stdout : NULL, m_logFileLevel >= LOG_LVL_DETAIL, "",
+                   m_gmlog_per_account ? NULL : gmLogfile);
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
+    va_end(ap);
 
+    // per account files are opened for each command, they are written at once
     if (m_gmlog_per_account)
     {
         if (FILE* per_file = openGmlogPerAccount(account))
         {
-            va_list ap;
-            outTimestamp(per_file);
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n");
-            va_end(ap);
+            boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+            outTimestamp(per_file, msg.time);
+            fprintf(per_file, "%s\n", msg.text.c_str());
             fclose(per_file);
         }
     }
-    else if (gmLogfile)
-    {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
-    }
 
-    fflush(stdout);
+    Write(msg);
 }
 
 void Log::outChar(const char* str, ...)
 {
-    if (!str)
+    if (!str || !charLogfile)
         return;
 
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    LogMessage msg(LogNormal, NULL, false, "", charLogfile);
+
+    va_list ap;
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
+    va_end(ap);
+
+    Write(msg);
 }
 
 void Log::outErrorScriptLib()
 {
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
+    std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : "<Scripting Library ERROR>: ";
 
-    fflush(stderr);
+    LogMessage msg(LogError, stderr, true, prefix.c_str(), scriptErrLogFile);
+    Write(msg);
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -851,55 +761,16 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : "<Scripting Library ERROR>: ";
 
-    if (m_includeTime)
-        outTime();
+    LogMessage msg(LogError, stderr, true, prefix.c_str(), scriptErrLogFile);
 
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    FormatMessage(msg, err, ap);
     va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
+    Write(msg);
 }
 
 void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeName, ByteBuffer const* packet, bool incoming)
@@ -940,23 +811,17 @@ void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const cha
 
 void Log::outRALog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !raLogfile)
         return;
 
-    boost::lock_guard<boost::mutex> GuardObj(m_worldLogMtx);
+    LogMessage msg(LogNormal, NULL, false, "", raLogfile);
 
-    if (raLogfile)
-    {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatMessage(msg, str, ap);
+    va_end(ap);
 
-    fflush(stdout);
+    Write(msg);
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -984,20 +849,26 @@ void Log::WaitBeforeContinueIfNeed()
 
 void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
+    // queued messages may refer to the closed file
+    bool async = m_writerThread != NULL;
+    StopAsyncWriter();
+
     m_scriptLibName = libName;
 
     if (scriptErrLogFile)
         fclose(scriptErrLogFile);
 
     if (!fname)
-    {
         scriptErrLogFile = NULL;
-        return;
+    else
+    {
+        std::string fileName = m_logsDir;
+        fileName.append(fname);
+        scriptErrLogFile = fopen(fileName.c_str(), "a");
     }
 
-    std::string fileName = m_logsDir;
-    fileName.append(fname);
-    scriptErrLogFile = fopen(fileName.c_str(), "a");
+    if (async)
+        StartAsyncWriter();
 }
 
 void outstring_log(const char* str, ...)
@@ -22,7 +22,10 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 
+#include <boost/atomic.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 class Config;
 class ByteBuffer;
@@ -92,6 +95,16 @@ enum Color
 
 const int Color_count = int(WHITE) + 1;
 
+enum LogType
+{
+    LogNormal = 0,
+    LogDetails,
+    LogDebug,
+    LogError
+};
+
+const int LogType_count = int(LogError) + 1;
+
 class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, boost::mutex> >
 {
         friend class MaNGOS::OperatorNew<Log>;
@@ -99,6 +112,9 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, boost:
 
         ~Log()
         {
+            // write everything still queued while the files are open
+            StopAsyncWriter();
+
             if (logfile != NULL)
                 fclose(logfile);
             logfile = NULL;
@@ -174,6 +190,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, boost:
         void ResetColor(bool stdout_stream);
         void outTime();
         static void outTimestamp(FILE* file);
+        static void outTimestamp(FILE* file, time_t t);
         static std::string GetTimestampStr();
         bool HasLogFilter(uint32 filter) const { return m_logFilter & filter; }
         void SetLogFilter(LogFilters filter, bool on) { if (on) m_logFilter |= filter; else m_logFilter &= ~filter; }
@@ -186,10 +203,46 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, boost:
         // Set filename for scriptlibrary error output
         void setScriptLibraryErrorFile(char const* fname, char const* libName);
 
+        // with the writer thread running callers only format and queue messages, the thread writes them in batches
+        void StartAsyncWriter();
+        // write all queued messages and return to direct output
+        void StopAsyncWriter();
+
     private:
+        // formatted message for the console and the log files
+        struct LogMessage
+        {
+            LogMessage() : type(LogNormal), time(0), stream(NULL), toLogfile(false), file(NULL) {}
+            LogMessage(LogType _type, FILE* _stream, bool _toLogfile, char const* _prefix = "", FILE* _file = NULL) :
+                type(_type), time(::time(NULL)), stream(_stream), toLogfile(_toLogfile), prefix(_prefix), file(_file) {}
+
+            LogType type;                                   // console color
+            time_t time;
+            FILE* stream;                                   // stdout, stderr or NULL for no console output
+            bool toLogfile;
+            std::string prefix;                             // written before the text in the main log file only
+            FILE* file;                                     // additional log file or NULL
+            std::string text;
+        };
+
+        typedef std::vector<LogMessage> LogQueue;
+
+        enum
+        {
+            ASYNC_BATCH_SIZE = 256                          // queued messages waking the writer before the flush interval
+        };
+
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        static void FormatMessage(LogMessage& msg, const char* format, va_list ap);
+        // queue the message for the writer thread or write it at once
+        void Write(LogMessage& msg);
+        // m_worldLogMtx must be held, files are not flushed
+        void WriteMessage(LogMessage const& msg);
+        void FlushFiles();
+        void WriterThread();
+
         FILE* raLogfile;
         FILE* logfile;
         FILE* gmLogfile;
@@ -220,6 +273,17 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, boost:
         std::string m_gmlog_filename_format;
 
         char const* m_scriptLibName;
+
+        // async output control
+        boost::thread* m_writerThread;
+        boost::atomic<bool> m_asyncRunning;                 // messages are queued, checked before locking m_queueMtx
+        boost::mutex m_queueMtx;                            // guards everything below
+        boost::condition_variable m_queueCondition;
+        LogQueue m_queue;
+        bool m_asyncStopping;
+        uint32 m_asyncDropped;                              // messages not queued because the queue was full
+        uint32 m_asyncMaxQueueSize;
+        uint32 m_asyncFlushInterval;
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace MaNGOS
+{
+    /**
+     * Lock-free multi-producer single-consumer queue.
+     *
+     * Any thread may add(), but only one thread at a time may call next().
+     * Producers never block each other or the consumer: an add is one
+     * allocation and one atomic exchange. An item added while the consumer
+     * reads may be seen only by the next call of next().
+     */
+    template <class T>
+    class MPSCQueue : public boost::noncopyable
+    {
+            struct Node
+            {
+                Node() : item(), nextNode(nullptr) {}
+                explicit Node(const T& i) : item(i), nextNode(nullptr) {}
+
+                T item;
+                boost::atomic<Node*> nextNode;
+            };
+
+            //! Last added node, producers swap in new nodes here.
+            boost::atomic<Node*> _head;
+
+            //! Already consumed node, the queue continues from its next node.
+            Node* _tail;
+
+        public:
+
+            //! Create a MPSCQueue.
+            MPSCQueue()
+            {
+                Node* stub = new Node();
+                _head.store(stub, boost::memory_order_relaxed);
+                _tail = stub;
+            }
+
+            //! Destroy a MPSCQueue, items left in queue are not deleted.
+            ~MPSCQueue()
+            {
+                while (Node* node = _tail)
+                {
+                    _tail = node->nextNode.load(boost::memory_order_relaxed);
+                    delete node;
+                }
+            }
+
+            //! Adds an item to the queue, may be called from any thread.
+            void add(const T& item)
+            {
+                Node* node = new Node(item);
+                Node* prev = _head.exchange(node, boost::memory_order_acq_rel);
+                prev->nextNode.store(node, boost::memory_order_release);
+            }
+
+            //! Gets the next item in the queue, if any. Consumer thread only.
+            bool next(T& result)
+            {
+                Node* node = _tail->nextNode.load(boost::memory_order_acquire);
+                if (!node)
+                    return false;
+
+                result = node->item;
+                pop(node);
+                return true;
+            }
+
+            //! Gets the next item only if checker accepts it, rejected item stays in front. Consumer thread only.
+            template<class Checker>
+            bool next(T& result, Checker& check)
+            {
+                Node* node = _tail->nextNode.load(boost::memory_order_acquire);
+                if (!node)
+                    return false;
+
+                result = node->item;
+                if (!check.Process(result))
+                    return false;
+
+                pop(node);
+                return true;
+            }
+
+            //! Checks if we're empty or not. Consumer thread only.
+            bool empty() const
+            {
+                return _tail->nextNode.load(boost::memory_order_acquire) == nullptr;
+            }
+
+        private:
+
+            //! Make node the new consumed one, freeing the previous.
+            void pop(Node* node)
+            {
+                Node* consumed = _tail;
+                _tail = node;
+                node->item = T();
+                delete consumed;
+            }
+    };
+}
+#endif
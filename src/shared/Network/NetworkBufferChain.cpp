@@ -0,0 +1,216 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cstring>
+#include "NetworkBufferChain.h"
+
+NetworkBufferPool& NetworkBufferPool::instance()
+{
+    static NetworkBufferPool pool;
+    return pool;
+}
+
+NetworkBufferPool::NetworkBufferPool() : max_free_(protocol::SEND_CHUNK_POOL_SIZE)
+{
+}
+
+NetworkBufferPool::~NetworkBufferPool()
+{
+    for (FreeList::iterator itr = free_.begin(); itr != free_.end(); ++itr)
+        delete *itr;
+}
+
+NetworkBuffer* NetworkBufferPool::acquire()
+{
+    {
+        boost::lock_guard<boost::mutex> guard(lock_);
+        if (!free_.empty())
+        {
+            NetworkBuffer* buffer = free_.back();
+            free_.pop_back();
+            return buffer;
+        }
+    }
+
+    return new NetworkBuffer(protocol::SEND_CHUNK_SIZE);
+}
+
+void NetworkBufferPool::release(NetworkBuffer* buffer)
+{
+    buffer->Reset();
+
+    {
+        boost::lock_guard<boost::mutex> guard(lock_);
+        if (free_.size() < max_free_)
+        {
+            free_.push_back(buffer);
+            return;
+        }
+    }
+
+    delete buffer;
+}
+
+void NetworkBufferPool::set_max_free(size_t count)
+{
+    FreeList excess;
+
+    {
+        boost::lock_guard<boost::mutex> guard(lock_);
+        max_free_ = count;
+        if (free_.size() > max_free_)
+        {
+            excess.assign(free_.begin() + max_free_, free_.end());
+            free_.resize(max_free_);
+        }
+    }
+
+    for (FreeList::iterator itr = excess.begin(); itr != excess.end(); ++itr)
+        delete *itr;
+}
+
+size_t NetworkBufferPool::free_count() const
+{
+    boost::lock_guard<boost::mutex> guard(lock_);
+    return free_.size();
+}
+
+NetworkBufferChain::NetworkBufferChain() : tail_(nullptr), tail_segments_(0), length_(0)
+{
+}
+
+NetworkBufferChain::~NetworkBufferChain()
+{
+    Clear();
+}
+
+void NetworkBufferChain::Write(const uint8* data, const size_t n)
+{
+    size_t written = 0;
+    while (written < n)
+    {
+        if (!tail_ || tail_->space() == 0)
+        {
+            // full buffer is released with its last segment, or now if that one is already sent
+            if (tail_ && !tail_segments_)
+                NetworkBufferPool::instance().release(tail_);
+
+            tail_ = NetworkBufferPool::instance().acquire();
+            tail_segments_ = 0;
+        }
+
+        // continue last segment or start a new one after data queued by reference
+        if (buffers_.empty() || buffers_.back().buffer != tail_)
+        {
+            buffers_.push_back(Segment(tail_, tail_->length()));
+            ++tail_segments_;
+        }
+
+        size_t part = std::min<size_t>(tail_->space(), n - written);
+        tail_->Write(data + written, part);
+        buffers_.back().end += part;
+        written += part;
+    }
+
+    length_ += n;
+}
+
+void NetworkBufferChain::Append(const SharedData& data)
+{
+    if (!data || data->empty())
+        return;
+
+    buffers_.push_back(Segment(data));
+    length_ += data->size();
+}
+
+const uint8* NetworkBufferChain::read_data() const
+{
+    return buffers_.empty() ? nullptr : buffers_.front().read_data();
+}
+
+uint32 NetworkBufferChain::read_length() const
+{
+    return buffers_.empty() ? 0 : buffers_.front().length();
+}
+
+size_t NetworkBufferChain::GatherBuffers(std::vector<boost::asio::const_buffer>& buffers, size_t max_buffers) const
+{
+    size_t gathered = 0;
+    for (BufferList::const_iterator itr = buffers_.begin(); itr != buffers_.end() && max_buffers > 0; ++itr, --max_buffers)
+    {
+        buffers.push_back(boost::asio::const_buffer(itr->read_data(), itr->length()));
+        gathered += itr->length();
+    }
+
+    return gathered;
+}
+
+void NetworkBufferChain::Consume(size_t n)
+{
+    while (n > 0 && !buffers_.empty())
+    {
+        Segment& segment = buffers_.front();
+        size_t part = std::min<size_t>(segment.length(), n);
+        segment.offset += part;
+
+        length_ -= part;
+        n -= part;
+
+        if (segment.length() == 0)
+        {
+            ReleaseSegment(segment);
+            buffers_.pop_front();
+        }
+    }
+
+    // idle connection holds no output memory
+    if (buffers_.empty() && tail_)
+    {
+        NetworkBufferPool::instance().release(tail_);
+        tail_ = nullptr;
+        tail_segments_ = 0;
+    }
+}
+
+void NetworkBufferChain::ReleaseSegment(const Segment& segment)
+{
+    if (!segment.buffer)
+        return;
+
+    if (segment.buffer == tail_)
+        --tail_segments_;
+    // no more writes go to a full buffer, its last segment is the last user
+    else if (segment.end == segment.buffer->length())
+        NetworkBufferPool::instance().release(segment.buffer);
+}
+
+void NetworkBufferChain::Clear()
+{
+    for (BufferList::iterator itr = buffers_.begin(); itr != buffers_.end(); ++itr)
+        ReleaseSegment(*itr);
+
+    if (tail_)
+        NetworkBufferPool::instance().release(tail_);
+
+    buffers_.clear();
+    tail_ = nullptr;
+    tail_segments_ = 0;
+    length_ = 0;
+}
@@ -0,0 +1,123 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef NETWORK_BUFFER_CHAIN_H
+#define NETWORK_BUFFER_CHAIN_H
+
+#include <deque>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/shared_ptr.hpp>
+#include "NetworkBuffer.h"
+#include "ByteBuffer.h"
+
+/// Process wide free list of fixed size buffers used by NetworkBufferChain
+class NetworkBufferPool
+{
+public:
+    static NetworkBufferPool& instance();
+
+    /// Get empty buffer of protocol::SEND_CHUNK_SIZE bytes
+    NetworkBuffer* acquire();
+    /// Give buffer back, freed if pool already holds max_free_ buffers
+    void release(NetworkBuffer* buffer);
+
+    void set_max_free(size_t count);
+    size_t free_count() const;
+
+private:
+    NetworkBufferPool();
+    ~NetworkBufferPool();
+
+    typedef std::vector<NetworkBuffer*> FreeList;
+
+    mutable boost::mutex lock_;
+    FreeList free_;
+    size_t max_free_;
+};
+
+/**
+ * Output queue of a socket: list of pooled fixed size buffers.
+ *
+ * Writes never fail and never move queued data, a new buffer is taken from
+ * the pool when the last one is full. Fully sent buffers go back to the pool,
+ * so an idle connection holds no output memory at all.
+ *
+ * Immutable data shared by several sockets (broadcast packet payloads) can be
+ * queued by reference instead, it is kept alive until it is sent. Writes after
+ * such a reference continue in the pooled buffer used before it, so a reference
+ * costs one list entry and no extra buffer.
+ */
+class NetworkBufferChain
+{
+public:
+    typedef boost::shared_ptr<ByteBuffer const> SharedData;
+
+    NetworkBufferChain();
+    ~NetworkBufferChain();
+
+    void Write(const uint8* data, const size_t n);
+
+    /// Queue content of data without copying it, data must not be changed anymore
+    void Append(const SharedData& data);
+
+    /// Contiguous not yet sent data at the front of the chain
+    const uint8* read_data() const;
+    uint32 read_length() const;
+
+    /// Append not yet sent data of up to max_buffers front buffers to buffers, returns appended byte count
+    size_t GatherBuffers(std::vector<boost::asio::const_buffer>& buffers, size_t max_buffers) const;
+
+    void Consume(size_t n);
+    void Clear();
+
+    size_t length() const { return length_; }
+    bool empty() const { return length_ == 0; }
+
+private:
+    NetworkBufferChain(const NetworkBufferChain&);
+    NetworkBufferChain& operator=(const NetworkBufferChain&);
+
+    /// Either part of a pooled buffer with packed writes or data queued by reference
+    struct Segment
+    {
+        Segment(NetworkBuffer* buffer_, size_t start) : buffer(buffer_), offset(start), end(start) {}
+        explicit Segment(const SharedData& data_) : buffer(nullptr), data(data_), offset(0), end(data_->size()) {}
+
+        const uint8* read_data() const { return (buffer ? buffer->read_data() : data->contents()) + offset; }
+        size_t length() const { return end - offset; }
+
+        NetworkBuffer* buffer;                              // pooled buffers are never consumed, read_data() is their start
+        SharedData data;
+        size_t offset;                                      // first not yet sent byte
+        size_t end;                                         // end of the segment data
+    };
+
+    typedef std::deque<Segment> BufferList;
+
+    /// Release buffer of a consumed segment unless later segments still use it
+    void ReleaseSegment(const Segment& segment);
+
+    BufferList buffers_;
+    NetworkBuffer* tail_;                                   // pooled buffer written to, can be shared by several segments
+    size_t tail_segments_;                                  // count of segments in buffers_ using tail_
+    size_t length_;
+};
+
+#endif // NETWORK_BUFFER_CHAIN_H
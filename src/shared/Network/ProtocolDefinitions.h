@@ -33,7 +33,14 @@ namespace protocol
     typedef boost::asio::io_service Service;
 
     const uint32 READ_BUFFER_SIZE = 4096;
-    const uint32 SEND_BUFFER_SIZE = 65536;
+    const uint32 SEND_BUFFER_SIZE = 65536;                  // default soft limit of queued output per connection
+    const uint32 SEND_HARD_LIMIT = 8 * 1024 * 1024;         // default hard limit, connection is closed above it
+    const uint32 SEND_CHUNK_SIZE = 4096;                    // size of one pooled output buffer
+    const uint32 SEND_CHUNK_POOL_SIZE = 4096;               // max count of free output buffers kept for reuse
+    const uint32 SEND_GATHER_MAX_BUFFERS = 64;              // max count of output buffers flushed by one gather send
+    // smaller shared payloads are copied, not queued by reference: a reference costs one queue entry
+    // (~48 bytes, ~35ns more than copying a small payload), below this size the copy takes less memory
+    const uint32 SEND_REFERENCE_MIN_SIZE = 64;
 }
 
 class Socket;
@@ -30,7 +30,8 @@
 const std::string Socket::UNKNOWN_NETWORK_ADDRESS = "<unknown>";
 
 Socket::Socket(NetworkManager& manager, NetworkThread& owner) : manager_(manager), owner_(owner), socket_(owner.service()),
-    outgoing_buffer_size_(protocol::SEND_BUFFER_SIZE), write_operation_(false), closed_(true), address_(UNKNOWN_NETWORK_ADDRESS)
+    outgoing_soft_limit_(protocol::SEND_BUFFER_SIZE), outgoing_hard_limit_(protocol::SEND_HARD_LIMIT), send_congested_(false),
+    gather_send_(false), write_operation_(false), closed_(true), address_(UNKNOWN_NETWORK_ADDRESS)
 {
 
 }
@@ -52,7 +53,7 @@ void Socket::CloseSocket(void)
 
 bool Socket::Open()
 {
-    if (out_buffer_.get())
+    if (read_buffer_.get())
         return false;
 
     // Store peer address.
@@ -72,8 +73,7 @@ bool Socket::Open()
 
     closed_ = false;
 
-    // Allocate buffers.
-    out_buffer_.reset(new NetworkBuffer(outgoing_buffer_size_));
+    // Allocate buffers, output buffers are taken from pool on demand.
     read_buffer_.reset(new NetworkBuffer(protocol::READ_BUFFER_SIZE));
 
     // Start reading data from client
@@ -133,9 +133,19 @@ bool Socket::SetSendBufferSize(int size)
     return true;
 }
 
-void Socket::SetOutgoingBufferSize(size_t size)
+void Socket::SetOutgoingBufferLimits(size_t soft_limit, size_t hard_limit)
 {
-    outgoing_buffer_size_ = size;
+    outgoing_soft_limit_ = soft_limit;
+    outgoing_hard_limit_ = std::max(soft_limit, hard_limit);
+}
+
+void Socket::UpdateSendCongestion()
+{
+    // hysteresis, don't flip state on every packet around the limit
+    if (!send_congested_ && out_buffer_.length() >= outgoing_soft_limit_)
+        send_congested_ = true;
+    else if (send_congested_ && out_buffer_.length() < outgoing_soft_limit_ / 2)
+        send_congested_ = false;
 }
 
 uint32 Socket::native_handle() 
@@ -151,7 +161,7 @@ void Socket::StartAsyncSend()
     if (write_operation_)
         return;
     
-    if (out_buffer_->length() == 0)
+    if (out_buffer_.empty())
     {
         write_operation_ = false;
         return;
@@ -159,7 +169,19 @@ void Socket::StartAsyncSend()
 
     write_operation_ = true;
 
-    socket_.async_write_some(boost::asio::buffer(out_buffer_->read_data(), out_buffer_->length()),
+    if (gather_send_)
+    {
+        // queued buffers are never moved by writes, so they stay valid until OnWriteComplete consumes them
+        send_buffers_.clear();
+        out_buffer_.GatherBuffers(send_buffers_, protocol::SEND_GATHER_MAX_BUFFERS);
+
+        socket_.async_write_some(send_buffers_,
+            boost::bind(&Socket::OnWriteComplete, shared_from_this(), boost::asio::placeholders::error,
+            boost::asio::placeholders::bytes_transferred));
+        return;
+    }
+
+    socket_.async_write_some(boost::asio::buffer(out_buffer_.read_data(), out_buffer_.read_length()),
         boost::bind(&Socket::OnWriteComplete, shared_from_this(), boost::asio::placeholders::error,
         boost::asio::placeholders::bytes_transferred));
 }
@@ -175,8 +197,8 @@ void Socket::OnWriteComplete(const boost::system::error_code& error, size_t byte
     GuardType Lock(out_buffer_lock_);
 
     write_operation_ = false;
-    out_buffer_->Consume(bytes_transferred);
-    out_buffer_->Prepare();
+    out_buffer_.Consume(bytes_transferred);
+    UpdateSendCongestion();
 
     StartAsyncSend();
 }
@@ -24,7 +24,9 @@
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_guard.hpp>
+#include <boost/atomic.hpp>
 #include "NetworkBuffer.h"
+#include "NetworkBufferChain.h"
 
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
@@ -59,8 +61,15 @@ public:
     /// Set SO_SDNBUF variable 
     bool SetSendBufferSize(int size);
 
-    /// Set custom value for outgoing buffer size
-    void SetOutgoingBufferSize(size_t size);
+    /// Set limits for queued output: above soft limit the socket reports congestion,
+    /// above hard limit the connection is closed
+    void SetOutgoingBufferLimits(size_t soft_limit, size_t hard_limit);
+
+    /// Flush all queued output buffers with one scatter-gather send instead of one send per buffer
+    void SetGatherSend(bool enable) { gather_send_ = enable; }
+
+    /// True while queued output is above soft limit (until it drains below half of it)
+    bool IsSendCongested() const { return send_congested_; }
 
     /// Get underlying socket object
     protocol::Socket& socket() { return socket_; }
@@ -73,6 +82,12 @@ protected:
     
     /// Schedule asynchronous send operation
     void StartAsyncSend();
+
+    /// Check if n more bytes fit below hard limit, must be called with out_buffer_lock_ held
+    bool CanQueueOutgoing(size_t n) const { return out_buffer_.length() + n <= outgoing_hard_limit_; }
+
+    /// Recalculate congestion state after output change, must be called with out_buffer_lock_ held
+    void UpdateSendCongestion();
     virtual bool ProcessIncomingData() = 0;
 
     uint32 native_handle();
@@ -84,8 +99,8 @@ protected:
     /// Mutex for protecting output related data.
     LockType out_buffer_lock_;
 
-    /// Buffer used for writing output.
-    std::auto_ptr<NetworkBuffer> out_buffer_;
+    /// Chain of pooled buffers used for writing output.
+    NetworkBufferChain out_buffer_;
 
     /// Buffer used for receiving input
     std::auto_ptr<NetworkBuffer> read_buffer_;
@@ -105,7 +120,11 @@ private:
     std::string ObtainRemoteAddress() const;
 
     protocol::Socket socket_;
-    size_t outgoing_buffer_size_;
+    size_t outgoing_soft_limit_;
+    size_t outgoing_hard_limit_;
+    boost::atomic<bool> send_congested_;
+    bool gather_send_;
+    std::vector<boost::asio::const_buffer> send_buffers_;
     std::string address_;
     bool write_operation_;
     bool closed_;
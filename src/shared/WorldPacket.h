@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include "WorldPacketFwd.h"
 #include "Opcodes.h"
 
 // Note: m_opcode and size stored in platfom dependent format
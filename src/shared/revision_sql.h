@@ -1,6 +1,6 @@
 #ifndef __REVISION_SQL_H__
 #define __REVISION_SQL_H__
  #define REVISION_DB_CHARACTERS "required_12763_00_characters_pvpstats"
- #define REVISION_DB_MANGOS "required_12848_01_mangos_spell_template"
+ #define REVISION_DB_MANGOS "required_12858_01_mangos_command"
  #define REVISION_DB_REALMD "required_10008_01_realmd_realmd_db_version"
 #endif // __REVISION_SQL_H__